@@ -91,6 +91,9 @@ namespace
     int  checkpoint_on_restart;
     bool checkpoint_files_output;
     int  compute_new_dt_on_regrid;
+    int  compact_time_history;
+    int  derive_cache;
+    int  subcycling_measured_cost;
     bool precreateDirectories;
     bool prereadFAHeaders;
     VisMF::Header::Version plot_headerversion(VisMF::Header::Version_v1);
@@ -103,6 +106,21 @@ Amr::UsingPrecreateDirectories()
     return precreateDirectories;
 }
 
+bool
+Amr::UsingDeriveCache ()
+{
+    return derive_cache;
+}
+
+void
+Amr::clearDeriveCaches ()
+{
+    for (int lev = 0; lev < amr_level.size(); ++lev)
+    {
+        if (amr_level[lev]) amr_level[lev]->clearDeriveCache();
+    }
+}
+
 void
 Amr::Initialize ()
 {
@@ -123,6 +141,9 @@ Amr::Initialize ()
     checkpoint_on_restart    = 0;
     checkpoint_files_output  = true;
     compute_new_dt_on_regrid = 0;
+    compact_time_history     = 0;
+    derive_cache             = 0;
+    subcycling_measured_cost = 1;
     precreateDirectories     = true;
     prereadFAHeaders         = true;
     plot_headerversion       = VisMF::Header::Version_v1;
@@ -255,6 +276,9 @@ Amr::InitAmr ()
     pp.query("checkpoint_on_restart",checkpoint_on_restart);
 
     pp.query("compute_new_dt_on_regrid",compute_new_dt_on_regrid);
+    pp.query("compact_time_history",compact_time_history);
+    pp.query("derive_cache",derive_cache);
+    pp.query("subcycling_measured_cost",subcycling_measured_cost);
 
     pp.query("mffile_nstreams", mffile_nstreams);
     pp.query("probinit_natonce", probinit_natonce);
@@ -319,6 +343,9 @@ Amr::InitAmr ()
     n_cycle.resize(nlev);
     dt_min.resize(nlev);
     amr_level.resize(nlev);
+    level_cost.resize(nlev, -1.0);
+    level_cost_time.resize(nlev, 0.0);
+    level_cost_cells.resize(nlev, 0.0);
     //
     // Set bogus values.
     //
@@ -1303,6 +1330,7 @@ Amr::FinalizeInit (Real              strt_time,
     for(int lev(0); lev <= finest_level; ++lev) {
       amr_level[lev]->post_init(stop_time);
     }
+    clearDeriveCaches();
 
     if (ParallelDescriptor::IOProcessor())
     {
@@ -1370,20 +1398,25 @@ Amr::restart (const std::string& filename)
       if(faHeaderFileChars.size() > 0) {  // ---- headers were read
         std::string faFileCharPtrString(faHeaderFileChars.dataPtr());
         std::istringstream fais(faFileCharPtrString, std::istringstream::in);
-        while ( ! fais.eof()) {  // ---- read and broadcast each header
+        Vector<std::string> faHeaderFullNames;
+        while ( ! fais.eof()) {
           std::string faHeaderName;
           fais >> faHeaderName;
           if( ! fais.eof()) {
-            std::string faHeaderFullName(filename + '/' + faHeaderName + "_H");
-            Vector<char> &tempCharArray = faHeaderMap[faHeaderFullName];
-            ParallelDescriptor::ReadAndBcastFile(faHeaderFullName, tempCharArray);
-	    if(verbose > 2) {
-		amrex::Print() 
-		    << ":::: faHeaderName faHeaderFullName tempCharArray.size() = " << faHeaderName
-		    << "  " << faHeaderFullName << "  " << tempCharArray.size() << "\n";
-	    }
+            faHeaderFullNames.push_back(filename + '/' + faHeaderName + "_H");
           }
         }
+        // ---- the headers are read by all ranks in turn and broadcast
+        Vector<Vector<char> > faHeaderChars;
+        ParallelDescriptor::ReadAndBcastFiles(faHeaderFullNames, faHeaderChars);
+        for(int i(0); i < faHeaderFullNames.size(); ++i) {
+	  if(verbose > 2) {
+	      amrex::Print() 
+		  << ":::: faHeaderFullName tempCharArray.size() = "
+		  << faHeaderFullNames[i] << "  " << faHeaderChars[i].size() << "\n";
+	  }
+          faHeaderMap[faHeaderFullNames[i]].swap(faHeaderChars[i]);
+        }
         StateData::SetFAHeaderMapPtr(&faHeaderMap);
       }
     }
@@ -1616,6 +1649,8 @@ Amr::restart (const std::string& filename)
        }
     }
 
+    StateData::SetFAHeaderMapPtr(nullptr);
+
     if (verbose > 0)
     {
         Real dRestartTime = ParallelDescriptor::second() - dRestartTime0;
@@ -1925,9 +1960,16 @@ Amr::timeStep (int  level,
 	amrex::Print() << "[Level " << level << " step " << level_steps[level]+1 << "] "
 		       << "ADVANCE with dt = " << dt_level[level] << "\n";
     }
+    clearDeriveCaches();
+    Real cost_strt = ParallelDescriptor::second();
     BL_PROFILE_REGION_START("amr_level.advance");
     Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
     BL_PROFILE_REGION_STOP("amr_level.advance");
+    if (measureLevelCost())
+    {
+        level_cost_time[level]  += ParallelDescriptor::second() - cost_strt;
+        level_cost_cells[level] += amr_level[level]->countCells();
+    }
 
     dt_min[level] = iteration == 1 ? dt_new : std::min(dt_min[level],dt_new);
 
@@ -1967,6 +2009,14 @@ Amr::timeStep (int  level,
     {
         const int lev_fine = level+1;
 
+        //
+        // While the finer levels advance, the old data of this level are
+        // only used for time interpolation.
+        //
+        if (compact_time_history) {
+            amr_level[level]->compactOldData();
+        }
+
         if (sub_cycle)
         {
             const int ncycle = n_cycle[lev_fine];
@@ -1980,9 +2030,27 @@ Amr::timeStep (int  level,
             BL_COMM_PROFILE_NAMETAG("Amr::timeStep timeStep nosubcycle");
             timeStep(lev_fine,time,1,1,stop_time);
         }
+
+        //
+        // The increments are relative to the new data, which post_timestep
+        // is about to change by refluxing and averaging down.
+        //
+        if (compact_time_history) {
+            amr_level[level]->expandOldData();
+        }
     }
 
+    //
+    // The advances have changed the data on this level and finer ones, so
+    // whatever was derived before is stale.
+    //
+    clearDeriveCaches();
+    cost_strt = ParallelDescriptor::second();
     amr_level[level]->post_timestep(iteration);
+    if (measureLevelCost())
+    {
+        level_cost_time[level] += ParallelDescriptor::second() - cost_strt;
+    }
 
     // Set this back to negative so we know whether we are in fact in this routine
     which_level_being_advanced = -1;
@@ -2038,6 +2106,8 @@ Amr::coarseTimeStep (Real stop_time)
 
     cumtime += dt_level[0];
 
+    updateLevelCost();
+
     amr_level[0]->postCoarseTimeStep(cumtime);
 
 #ifdef BL_PROFILING
@@ -2367,6 +2437,33 @@ Amr::regrid (int  lbase,
 	return;
     }
 
+    //
+    // With use_efficient_regrid, levels whose grids are unchanged and sit
+    // on coarser levels that are unchanged too keep their AmrLevel, so
+    // that the cost of the rebuild below grows with the number of levels
+    // that did change rather than with the number of levels.  Rebuilding
+    // them would only copy their data from themselves.
+    //
+    int rebuild_start = start;
+
+    if (use_efficient_regrid == 1 && !initial && !loadbalance_with_workestimates)
+    {
+        for (int lev = start, End = std::min(finest_level,new_finest); lev <= End; lev++)
+        {
+            if (new_grid_places[lev] == amr_level[lev]->boxArray()) {
+                rebuild_start = lev+1;
+            } else {
+                break;
+            }
+        }
+
+        if (verbose > 0 && rebuild_start > start) {
+            amrex::Print() << "Regridding at level lbase = " << lbase
+                           << " keeps unchanged levels " << start << " to "
+                           << rebuild_start-1 << "\n";
+        }
+    }
+
     //
     // Reclaim old-time grid space for all remain levels > lbase.
     //
@@ -2391,9 +2488,9 @@ Amr::regrid (int  lbase,
 #endif
 
     //
-    // Define the new grids from level start up to new_finest.
+    // Define the new grids from level rebuild_start up to new_finest.
     //
-    for(int lev = start; lev <= new_finest; ++lev) {
+    for(int lev = rebuild_start; lev <= new_finest; ++lev) {
         //
         // Construct skeleton of new level.
         //
@@ -2450,6 +2547,7 @@ Amr::regrid (int  lbase,
     for(int lev(0); lev <= new_finest; ++lev) {
       amr_level[lev]->post_regrid(lbase,new_finest);
     }
+    clearDeriveCaches();
 
     if(rebalance_grids > 0) {
       DistributionMapping::InitProximityMap();
@@ -3112,6 +3210,68 @@ Amr::computeOptimalSubcycling(int n, int* best, Real* dt_max, Real* est_work, in
     return best_dt;
 }
 
+bool
+Amr::measureLevelCost () const
+{
+    return subcycling_mode == "Optimal" && subcycling_measured_cost;
+}
+
+void
+Amr::updateLevelCost ()
+{
+    if (!measureLevelCost()) return;
+
+    const int nlev = finest_level+1;
+    //
+    // A level is only as fast as its slowest process.
+    //
+    Vector<Real> t(level_cost_time.begin(), level_cost_time.begin()+nlev);
+    ParallelDescriptor::ReduceRealMax(t.dataPtr(), nlev);
+
+    for (int lev = 0; lev < nlev; ++lev)
+    {
+        if (level_cost_cells[lev] > 0.0 && t[lev] > 0.0)
+        {
+            const Real sample = t[lev] / level_cost_cells[lev];
+            //
+            // Damp the noise of single steps.
+            //
+            level_cost[lev] = (level_cost[lev] > 0.0) ? 0.5*(level_cost[lev] + sample) : sample;
+        }
+        level_cost_time[lev]  = 0.0;
+        level_cost_cells[lev] = 0.0;
+    }
+
+    if (verbose > 1)
+    {
+        amrex::Print() << "Measured cost per cell per advance:";
+        for (int lev = 0; lev < nlev; ++lev) {
+            amrex::Print() << " " << level_cost[lev];
+        }
+        amrex::Print() << "\n";
+    }
+}
+
+Real
+Amr::costPerCellEstimate (int lev) const
+{
+    if (!measureLevelCost()) return -1.0;
+
+    if (lev < level_cost.size() && level_cost[lev] > 0.0) return level_cost[lev];
+
+    Real sum = 0.0;
+    int  cnt = 0;
+    for (int i = 0; i < level_cost.size(); ++i)
+    {
+        if (level_cost[i] > 0.0)
+        {
+            sum += level_cost[i];
+            ++cnt;
+        }
+    }
+    return (cnt > 0) ? sum/cnt : -1.0;
+}
+
 const Vector<BoxArray>& Amr::getInitialBA()
 {
   return initial_ba;
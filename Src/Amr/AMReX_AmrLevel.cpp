@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include <memory>
 #include <limits>
+#include <algorithm>
 
 #include <AMReX_AmrLevel.H>
 #include <AMReX_Derive.H>
@@ -398,6 +399,7 @@ AmrLevel::setTimeLevel (Real time,
     {
         state[k].setTimeLevel(time,dt_old,dt_new);
     }
+    clearDeriveCache();
 }
 
 bool
@@ -522,6 +524,24 @@ AmrLevel::removeOldData ()
     }
 }
 
+void
+AmrLevel::compactOldData ()
+{
+    for (int i = 0; i < desc_lst.size(); i++)
+    {
+        state[i].compactOldData();
+    }
+}
+
+void
+AmrLevel::expandOldData ()
+{
+    for (int i = 0; i < desc_lst.size(); i++)
+    {
+        state[i].expandOldData();
+    }
+}
+
 void
 AmrLevel::reset ()
 {
@@ -529,6 +549,7 @@ AmrLevel::reset ()
     {
         state[i].reset();
     }
+    clearDeriveCache();
 }
 
 MultiFab&
@@ -1028,13 +1049,14 @@ FillPatchIterator::FillFromLevel0 (Real time, int idx, int scomp, int dcomp, int
 
     Vector<MultiFab*> smf;
     Vector<Real> stime;
-    statedata.getData(smf,stime,time);
+    TimeIncrement sinc;
+    statedata.getData(smf,stime,sinc,time);
 
     const Geometry& geom = m_amrlevel.geom;
 
     StateDataPhysBCFunct physbcf(statedata,scomp,geom);
 
-    amrex::FillPatchSingleLevel (m_fabs, time, smf, stime, scomp, dcomp, ncomp, geom, physbcf);
+    amrex::FillPatchSingleLevel (m_fabs, time, smf, stime, scomp, dcomp, ncomp, geom, physbcf, sinc);
 }
 
 void
@@ -1053,26 +1075,33 @@ FillPatchIterator::FillFromTwoLevels (Real time, int idx, int scomp, int dcomp,
     
     Vector<MultiFab*> smf_crse;
     Vector<Real> stime_crse;
+    TimeIncrement sinc_crse;
     StateData& statedata_crse = crse_level.state[idx];
-    statedata_crse.getData(smf_crse,stime_crse,time);
+    statedata_crse.getData(smf_crse,stime_crse,sinc_crse,time);
     StateDataPhysBCFunct physbcf_crse(statedata_crse,scomp,geom_crse);
 
     Vector<MultiFab*> smf_fine;
     Vector<Real> stime_fine;
+    TimeIncrement sinc_fine;
     StateData& statedata_fine = fine_level.state[idx];
-    statedata_fine.getData(smf_fine,stime_fine,time);
+    statedata_fine.getData(smf_fine,stime_fine,sinc_fine,time);
     StateDataPhysBCFunct physbcf_fine(statedata_fine,scomp,geom_fine);
 
     const StateDescriptor& desc = AmrLevel::desc_lst[idx];
 
-    amrex::FillPatchTwoLevels(m_fabs, time, 
-			       smf_crse, stime_crse, 
-			       smf_fine, stime_fine,
-			       scomp, dcomp, ncomp, 
-			       geom_crse, geom_fine,
-			       physbcf_crse, physbcf_fine,
-			       crse_level.fineRatio(), 
-			       desc.interp(scomp), desc.getBCs());
+    auto& plans = fine_level.fillpatch_plan;
+    if (static_cast<int>(plans.size()) <= idx) plans.resize(idx+1);
+    if (!plans[idx]) plans[idx].reset(new FillPatchPlan());
+
+    plans[idx]->FillPatchTwoLevels(m_fabs, time,
+                                   smf_crse, stime_crse,
+                                   smf_fine, stime_fine,
+                                   scomp, dcomp, ncomp,
+                                   geom_crse, geom_fine,
+                                   physbcf_crse, physbcf_fine,
+                                   crse_level.fineRatio(),
+                                   desc.interp(scomp), desc.getBCs(),
+                                   sinc_crse, sinc_fine);
 }
 
 static
@@ -1500,12 +1529,13 @@ AmrLevel::FillCoarsePatch (MultiFab& mf,
 	    
 	    Vector<MultiFab*> smf;
 	    Vector<Real> stime;
-	    statedata.getData(smf,stime,time);
+	    TimeIncrement sinc;
+	    statedata.getData(smf,stime,sinc,time);
 
 	    StateDataPhysBCFunct physbcf(statedata,SComp,cgeom);
 
             crseMF.setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), cgeom);
-	    amrex::FillPatchSingleLevel(crseMF,time,smf,stime,SComp,0,NComp,cgeom,physbcf);
+	    amrex::FillPatchSingleLevel(crseMF,time,smf,stime,SComp,0,NComp,cgeom,physbcf,sinc);
 	}
 	else
 	{
@@ -1558,7 +1588,16 @@ AmrLevel::derive (const std::string& name,
     if (isStateVariable(name, index, scomp))
     {
         mf.reset(new MultiFab(state[index].boxArray(), dmap, 1, ngrow, MFInfo(), *m_factory));
-        FillPatch(*this,*mf,ngrow,time,index,scomp,1);
+        if (useDeriveCache())
+        {
+            int src_comp;
+            const MultiFab& src = getDeriveSource(index,scomp,1,ngrow,time,src_comp);
+            MultiFab::Copy(*mf,src,src_comp,0,1,ngrow);
+        }
+        else
+        {
+            FillPatch(*this,*mf,ngrow,time,index,scomp,1);
+        }
     }
     else if (const DeriveRec* rec = derive_lst.get(name))
     {
@@ -1569,6 +1608,19 @@ AmrLevel::derive (const std::string& name,
         BoxArray dstBA(srcBA);
         dstBA.convert(rec->deriveType());
 
+        const auto key = std::make_tuple(name, time, parent->dtLevel(level), ngrow);
+
+        if (useDeriveCache())
+        {
+            auto it = derive_cache.find(key);
+            if (it != derive_cache.end())
+            {
+                mf.reset(new MultiFab(dstBA, dmap, rec->numDerive(), ngrow, MFInfo(), *m_factory));
+                MultiFab::Copy(*mf,*it->second,0,0,rec->numDerive(),ngrow);
+                return mf;
+            }
+        }
+
 	int ngrow_src = ngrow;
 	{
 	    Box bx0 = srcBA[0];
@@ -1577,13 +1629,9 @@ AmrLevel::derive (const std::string& name,
 	    ngrow_src += g;
 	}
 
-        MultiFab srcMF(srcBA, dmap, rec->numState(), ngrow_src, MFInfo(), *m_factory);
-
-        for (int k = 0, dc = 0; k < rec->numRange(); k++, dc += ncomp)
-        {
-            rec->getRange(k, index, scomp, ncomp);
-            FillPatch(*this,srcMF,ngrow_src,time,index,scomp,ncomp,dc);
-        }
+        std::unique_ptr<MultiFab> tmp;
+        int src_comp;
+        MultiFab& srcMF = getDeriveSource(*rec,ngrow_src,time,tmp,src_comp);
 
         mf.reset(new MultiFab(dstBA, dmap, rec->numDerive(), ngrow, MFInfo(), *m_factory));
 
@@ -1601,7 +1649,7 @@ AmrLevel::derive (const std::string& name,
 	    const int*  lo      = gtbx.loVect();
 	    const int*  hi      = gtbx.hiVect();
             int         n_der   = rec->numDerive();
-            Real*       cdat    = srcMF[mfi].dataPtr();
+            Real*       cdat    = srcMF[mfi].dataPtr(src_comp);
             const int*  clo     = srcMF[mfi].loVect();
             const int*  chi     = srcMF[mfi].hiVect();
             int         n_state = rec->numState();
@@ -1640,7 +1688,7 @@ AmrLevel::derive (const std::string& name,
             const int*  dlo     = (*mf)[mfi].loVect();
             const int*  dhi     = (*mf)[mfi].hiVect();
             int         n_der   = rec->numDerive();
-            Real*       cdat    = srcMF[mfi].dataPtr();
+            Real*       cdat    = srcMF[mfi].dataPtr(src_comp);
             const int*  clo     = srcMF[mfi].loVect();
             const int*  chi     = srcMF[mfi].hiVect();
             int         n_state = rec->numState();
@@ -1670,6 +1718,13 @@ AmrLevel::derive (const std::string& name,
 	    }
         }
 #endif
+
+        if (useDeriveCache())
+        {
+            std::unique_ptr<MultiFab>& cached = derive_cache[key];
+            cached.reset(new MultiFab(dstBA, dmap, rec->numDerive(), ngrow, MFInfo(), *m_factory));
+            MultiFab::Copy(*cached,*mf,0,0,rec->numDerive(),ngrow);
+        }
     }
     else
     {
@@ -1698,7 +1753,17 @@ AmrLevel::derive (const std::string& name,
 
     if (isStateVariable(name,index,scomp))
     {
-        FillPatch(*this,mf,ngrow,time,index,scomp,1);
+        if (useDeriveCache() &&
+            mf.boxArray() == state[index].boxArray() && mf.DistributionMap() == dmap)
+        {
+            int src_comp;
+            const MultiFab& src = getDeriveSource(index,scomp,1,ngrow,time,src_comp);
+            MultiFab::Copy(mf,src,src_comp,dcomp,1,ngrow);
+        }
+        else
+        {
+            FillPatch(*this,mf,ngrow,time,index,scomp,1,dcomp);
+        }
     }
     else if (const DeriveRec* rec = derive_lst.get(name))
     {
@@ -1706,6 +1771,24 @@ AmrLevel::derive (const std::string& name,
 
         const BoxArray& srcBA = state[index].boxArray();
 
+        BoxArray dstBA(srcBA);
+        dstBA.convert(rec->deriveType());
+
+        const auto key = std::make_tuple(name, time, parent->dtLevel(level), ngrow);
+
+        const bool use_cache = useDeriveCache() &&
+            mf.boxArray() == dstBA && mf.DistributionMap() == dmap;
+
+        if (use_cache)
+        {
+            auto it = derive_cache.find(key);
+            if (it != derive_cache.end())
+            {
+                MultiFab::Copy(mf,*it->second,0,dcomp,rec->numDerive(),ngrow);
+                return;
+            }
+        }
+
 	int ngrow_src = ngrow;
 	{
 	    Box bx0 = srcBA[0];
@@ -1714,14 +1797,9 @@ AmrLevel::derive (const std::string& name,
 	    ngrow_src += g;
 	}
 
-        MultiFab srcMF(srcBA,dmap,rec->numState(),ngrow_src, MFInfo(), *m_factory);
-
-        for (int k = 0, dc = 0; k < rec->numRange(); k++, dc += ncomp)
-        {
-            rec->getRange(k,index,scomp,ncomp);
-
-            FillPatch(*this,srcMF,ngrow_src,time,index,scomp,ncomp,dc);
-        }
+        std::unique_ptr<MultiFab> tmp;
+        int src_comp;
+        MultiFab& srcMF = getDeriveSource(*rec,ngrow_src,time,tmp,src_comp);
 
 #ifdef CRSEGRNDOMP
 #ifdef _OPENMP
@@ -1737,7 +1815,7 @@ AmrLevel::derive (const std::string& name,
 	    const int*  lo      = gtbx.loVect();
 	    const int*  hi      = gtbx.hiVect();
             int         n_der   = rec->numDerive();
-            Real*       cdat    = srcMF[mfi].dataPtr();
+            Real*       cdat    = srcMF[mfi].dataPtr(src_comp);
             const int*  clo     = srcMF[mfi].loVect();
             const int*  chi     = srcMF[mfi].hiVect();
             int         n_state = rec->numState();
@@ -1775,7 +1853,7 @@ AmrLevel::derive (const std::string& name,
             const int*  dlo     = mf[mfi].loVect();
             const int*  dhi     = mf[mfi].hiVect();
             int         n_der   = rec->numDerive();
-            Real*       cdat    = srcMF[mfi].dataPtr();
+            Real*       cdat    = srcMF[mfi].dataPtr(src_comp);
             const int*  clo     = srcMF[mfi].loVect();
             const int*  chi     = srcMF[mfi].hiVect();
             int         n_state = rec->numState();
@@ -1806,6 +1884,13 @@ AmrLevel::derive (const std::string& name,
 	    }
         }
 #endif
+
+        if (use_cache)
+        {
+            std::unique_ptr<MultiFab>& cached = derive_cache[key];
+            cached.reset(new MultiFab(dstBA, dmap, rec->numDerive(), ngrow, MFInfo(), *m_factory));
+            MultiFab::Copy(*cached,mf,dcomp,0,rec->numDerive(),ngrow);
+        }
     }
     else
     {
@@ -1818,6 +1903,94 @@ AmrLevel::derive (const std::string& name,
     }
 }
 
+void
+AmrLevel::clearDeriveCache ()
+{
+    derive_cache.clear();
+    derive_src_cache.clear();
+}
+
+bool
+AmrLevel::useDeriveCache () const
+{
+    return Amr::UsingDeriveCache();
+}
+
+MultiFab&
+AmrLevel::getDeriveSource (int  index,
+                           int  scomp,
+                           int  ncomp,
+                           int  ngrow,
+                           Real time,
+                           int& src_comp)
+{
+    for (auto& src : derive_src_cache)
+    {
+        if (src.index == index && src.time == time && src.ngrow >= ngrow &&
+            src.scomp <= scomp && scomp+ncomp <= src.scomp+src.ncomp)
+        {
+            src_comp = scomp - src.scomp;
+            return *src.mf;
+        }
+    }
+
+    std::unique_ptr<MultiFab> mf(new MultiFab(state[index].boxArray(), dmap, ncomp, ngrow,
+                                              MFInfo(), *m_factory));
+    FillPatch(*this,*mf,ngrow,time,index,scomp,ncomp);
+
+    DeriveSource src;
+    src.index = index;
+    src.scomp = scomp;
+    src.ncomp = ncomp;
+    src.ngrow = ngrow;
+    src.time  = time;
+    src.mf    = std::move(mf);
+    derive_src_cache.push_back(std::move(src));
+
+    src_comp = 0;
+    return *derive_src_cache.back().mf;
+}
+
+MultiFab&
+AmrLevel::getDeriveSource (const DeriveRec&           rec,
+                           int                        ngrow,
+                           Real                       time,
+                           std::unique_ptr<MultiFab>& tmp,
+                           int&                       src_comp)
+{
+    int index, scomp, ncomp;
+
+    rec.getRange(0,index,scomp,ncomp);
+
+    if (useDeriveCache() && rec.numRange() == 1)
+    {
+        return getDeriveSource(index,scomp,ncomp,ngrow,time,src_comp);
+    }
+
+    const BoxArray& srcBA = state[index].boxArray();
+
+    tmp.reset(new MultiFab(srcBA, dmap, rec.numState(), ngrow, MFInfo(), *m_factory));
+    src_comp = 0;
+
+    for (int k = 0, dc = 0; k < rec.numRange(); k++, dc += ncomp)
+    {
+        rec.getRange(k,index,scomp,ncomp);
+
+        if (useDeriveCache())
+        {
+            int sc;
+            const MultiFab& src = getDeriveSource(index,scomp,ncomp,ngrow,time,sc);
+            MultiFab::Copy(*tmp,src,sc,dc,ncomp,ngrow);
+        }
+        else
+        {
+            FillPatch(*this,*tmp,ngrow,time,index,scomp,ncomp,dc);
+        }
+    }
+
+    return *tmp;
+}
+
 //! Update the distribution maps in StateData based on the size of the map
 void
 AmrLevel::UpdateDistributionMaps ( DistributionMapping& update_dmap )
@@ -2014,7 +2187,8 @@ AmrLevel::which_time (int  indx,
 Real
 AmrLevel::estimateWork ()
 {
-    return 1.0*countCells();
+    const Real cost = parent->costPerCellEstimate(level);
+    return (cost > 0.0) ? cost*countCells() : 1.0*countCells();
 }
 
 bool
@@ -2114,6 +2288,176 @@ AmrLevel::FillPatchAdd(AmrLevel& amrlevel,
     MultiFab::Add(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+void
+AmrLevel::FillPatch (AmrLevel& amrlevel,
+                     const Vector<FillPatchRequest>& requests,
+                     Real time)
+{
+    BL_PROFILE("AmrLevel::FillPatch(batched)");
+
+    const int level = amrlevel.level;
+    const Geometry& geom = amrlevel.geom;
+
+    // Requests that share an exchange, by index type.
+    Vector<std::pair<IndexType,Vector<int> > > groups;
+
+    for (int i = 0, N = requests.size(); i < N; ++i)
+    {
+        const FillPatchRequest& r = requests[i];
+
+        BL_ASSERT(r.dest != nullptr);
+        BL_ASSERT(r.ncomp >= 1);
+        BL_ASSERT(r.dcomp+r.ncomp <= r.dest->nComp());
+        BL_ASSERT(r.ngrow <= r.dest->nGrow());
+        BL_ASSERT(0 <= r.index && r.index < AmrLevel::desc_lst.size());
+        BL_ASSERT(AmrLevel::desc_lst[r.index].inRange(r.scomp,r.ncomp));
+
+        const StateDescriptor& desc = AmrLevel::desc_lst[r.index];
+        const IndexType& typ = desc.getType();
+
+        bool nested = true;
+        if (level > 1)
+        {
+            for (const auto& range : desc.sameInterps(r.scomp,r.ncomp))
+            {
+                nested = nested && amrex::ProperlyNested(amrlevel.crse_ratio,
+                                                         amrlevel.parent->blockingFactor(level),
+                                                         r.ngrow, typ, desc.interp(range.first));
+            }
+        }
+
+        if (!nested)
+        {
+            FillPatch(amrlevel, *r.dest, r.ngrow, time, r.index, r.scomp, r.ncomp, r.dcomp);
+            continue;
+        }
+
+        auto it = std::find_if(groups.begin(), groups.end(),
+                               [&typ] (const std::pair<IndexType,Vector<int> >& g)
+                               { return g.first == typ; });
+        if (it == groups.end()) {
+            groups.push_back({typ, Vector<int>(1,i)});
+        } else {
+            it->second.push_back(i);
+        }
+    }
+
+    for (const auto& g : groups)
+    {
+        const Vector<int>& ireq = g.second;
+        const int nreq = ireq.size();
+
+        Vector<int> offset(nreq);
+        int ntot = 0, ngrow = 0;
+        for (int j = 0; j < nreq; ++j)
+        {
+            const FillPatchRequest& r = requests[ireq[j]];
+            offset[j] = ntot;
+            ntot += r.ncomp;
+            ngrow = std::max(ngrow, r.ngrow);
+        }
+
+        const FillPatchRequest& r0 = requests[ireq[0]];
+        const MultiFab& S0 = amrlevel.state[r0.index].newData();
+        MultiFab fabs(S0.boxArray(), S0.DistributionMap(), ntot, ngrow, MFInfo(),
+                      r0.dest->Factory());
+        fabs.setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), geom);
+
+        Vector<Vector<MultiFab*> > smf(nreq);
+        Vector<Vector<Real> > stime(nreq);
+        Vector<TimeIncrement> sinc(nreq);
+        for (int j = 0; j < nreq; ++j)
+        {
+            const FillPatchRequest& r = requests[ireq[j]];
+            BL_ASSERT(r.dest->boxArray() == S0.boxArray());
+            amrlevel.state[r.index].getData(smf[j],stime[j],sinc[j],time);
+            if (stime[j].size() > 2) {
+                amrex::Abort("AmrLevel::FillPatch: high-order interpolation in time not implemented yet");
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(fabs,true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            for (int j = 0; j < nreq; ++j)
+            {
+                const FillPatchRequest& r = requests[ireq[j]];
+                if (sinc[j]) {
+                    sinc[j].apply(fabs[mfi], offset[j], (*smf[j][0])[mfi], r.scomp, mfi, bx, r.ncomp);
+                } else if (smf[j].size() == 1) {
+                    fabs[mfi].copy((*smf[j][0])[mfi], bx, r.scomp, bx, offset[j], r.ncomp);
+                } else {
+                    fabs[mfi].linInterp((*smf[j][0])[mfi], r.scomp, (*smf[j][1])[mfi], r.scomp,
+                                        stime[j][0], stime[j][1], time, bx, offset[j], r.ncomp);
+                }
+            }
+        }
+
+        fabs.FillBoundary_nowait(geom.periodicity());
+
+        if (level > 0)
+        {
+            AmrLevel& crse_level = amrlevel.parent->getLevel(level-1);
+            const Geometry& cgeom = crse_level.geom;
+
+            for (int j = 0; j < nreq; ++j)
+            {
+                const FillPatchRequest& r = requests[ireq[j]];
+                const StateDescriptor& desc = AmrLevel::desc_lst[r.index];
+
+                Vector<MultiFab*> cmf;
+                Vector<Real> ctime;
+                TimeIncrement cinc;
+                StateData& statedata_crse = crse_level.state[r.index];
+                statedata_crse.getData(cmf,ctime,cinc,time);
+
+                auto& plans = amrlevel.fillpatch_plan;
+                if (static_cast<int>(plans.size()) <= r.index) plans.resize(r.index+1);
+                if (!plans[r.index]) plans[r.index].reset(new FillPatchPlan());
+
+                int DComp = offset[j];
+                for (const auto& range : desc.sameInterps(r.scomp,r.ncomp))
+                {
+                    const int SComp = range.first;
+                    const int NComp = range.second;
+                    StateDataPhysBCFunct physbcf_crse(statedata_crse,SComp,cgeom);
+                    plans[r.index]->FillFromCoarseLevel(fabs, r.ngrow, time, cmf, ctime,
+                                                        *smf[j][0], SComp, DComp, NComp,
+                                                        cgeom, geom, physbcf_crse,
+                                                        crse_level.fineRatio(),
+                                                        desc.interp(SComp), desc.getBCs(),
+                                                        cinc);
+                    DComp += NComp;
+                }
+            }
+        }
+
+        fabs.FillBoundary_finish();
+
+        for (int j = 0; j < nreq; ++j)
+        {
+            const FillPatchRequest& r = requests[ireq[j]];
+            const StateDescriptor& desc = AmrLevel::desc_lst[r.index];
+
+            int DComp = offset[j];
+            for (const auto& range : desc.sameInterps(r.scomp,r.ncomp))
+            {
+                StateDataPhysBCFunct physbcf(amrlevel.state[r.index],range.first,geom);
+                physbcf.FillBoundary(fabs, DComp, range.second, time);
+                DComp += range.second;
+            }
+
+            amrlevel.set_preferred_boundary_values(fabs, r.index, r.scomp, offset[j],
+                                                   r.ncomp, time);
+
+            MultiFab::Copy(*r.dest, fabs, offset[j], r.dcomp, r.ncomp, r.ngrow);
+        }
+    }
+}
+
 
 
 void
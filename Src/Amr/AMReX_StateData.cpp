@@ -120,15 +120,25 @@ StateData::copyOld (const StateData& state)
   BL_ASSERT(state.hasOldData());
   BL_ASSERT(old_data != 0);
 
-  const MultiFab& MF = state.oldData();
+  if (state.hasCompactOldData())
+  {
+      BL_ASSERT(state.newData().nComp() == (*old_data).nComp());
+      BL_ASSERT(state.newData().nGrow() == (*old_data).nGrow());
 
-  int nc = MF.nComp();
-  int ng = MF.nGrow();
+      buildOldData(*old_data, state.newData(), *state.old_incr, 1.0);
+  }
+  else
+  {
+      const MultiFab& MF = state.oldData();
 
-  BL_ASSERT(nc == (*old_data).nComp());
-  BL_ASSERT(ng == (*old_data).nGrow());
+      int nc = MF.nComp();
+      int ng = MF.nGrow();
 
-  MultiFab::Copy(*old_data, state.oldData(), 0, 0, nc, ng);
+      BL_ASSERT(nc == (*old_data).nComp());
+      BL_ASSERT(ng == (*old_data).nGrow());
+
+      MultiFab::Copy(*old_data, state.oldData(), 0, 0, nc, ng);
+  }
 
   StateDescriptor::TimeCenter t_typ(desc->timeType());
 
@@ -153,6 +163,8 @@ StateData::copyNew (const StateData& state)
   BL_ASSERT(state.hasNewData());
   BL_ASSERT(new_data != 0);
 
+  if (old_incr) expandOldData();
+
   const MultiFab& MF = state.newData();
 
   int nc = MF.nComp();
@@ -182,6 +194,7 @@ StateData::copyNew (const StateData& state)
 void
 StateData::reset ()
 {
+    if (old_incr) expandOldData();
     new_time = old_time;
     old_time.start = old_time.stop = INVALID_TIME;
     std::swap(old_data, new_data);
@@ -284,6 +297,11 @@ StateData::restartDoit (std::istream& is, const std::string& chkfile)
       }
 
       VisMF::Read(*whichMF, FullPathName, faHeader);
+
+      // ---- each header is only needed once
+      if(faHeader != 0) {
+        faHeaderMap->erase(FullHeaderPathName);
+      }
     }
 }
 
@@ -313,7 +331,11 @@ StateData::~StateData()
 void
 StateData::allocOldData ()
 {
-    if (old_data == 0)
+    if (old_incr)
+    {
+        expandOldData();
+    }
+    else if (old_data == 0)
     {
         old_data = new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory);
     }
@@ -403,12 +425,27 @@ StateData::swapTimeLevels (Real dt)
         new_time.start = new_time.stop;
         new_time.stop += dt;
     }
-    std::swap(old_data, new_data);
+    if (old_incr)
+    {
+        //
+        // The increment is discarded and the new data become the old
+        // data; the new data are allocated afresh.
+        //
+        old_incr.reset();
+        BL_ASSERT(old_data == 0);
+        old_data = new_data;
+        new_data = new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory);
+    }
+    else
+    {
+        std::swap(old_data, new_data);
+    }
 }
 
 void
 StateData::replaceOldData (MultiFab* mf)
 {
+    old_incr.reset();
     std::swap(old_data, mf);
     delete mf;
 }
@@ -418,12 +455,15 @@ StateData::replaceOldData (MultiFab* mf)
 void
 StateData::replaceOldData (StateData& s)
 {
+    if (old_incr) expandOldData();
+    if (s.old_incr) s.expandOldData();
     std::swap(old_data, s.old_data);
 }
 
 void
 StateData::replaceNewData (MultiFab* mf)
 {
+    if (old_incr) expandOldData();
     std::swap(new_data, mf);
     delete mf;
 }
@@ -433,9 +473,81 @@ StateData::replaceNewData (MultiFab* mf)
 void
 StateData::replaceNewData (StateData& s)
 {
+    if (old_incr) expandOldData();
+    if (s.old_incr) s.expandOldData();
     std::swap(new_data, s.new_data);
 }
 
+void
+StateData::compactOldData ()
+{
+    BL_PROFILE("StateData::compactOldData()");
+
+    if (old_data == 0 || old_incr) return;
+
+    BL_ASSERT(new_data != 0);
+
+    const int ncomp = desc->nComp();
+
+    old_incr.reset(new FabArray<BaseFab<float> >(grids,dmap,ncomp,desc->nExtra()));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(*old_incr); mfi.isValid(); ++mfi)
+    {
+        BL_ASSERT((*old_incr)[mfi].box() == (*new_data)[mfi].box());
+        const Real* pnew = (*new_data)[mfi].dataPtr();
+        const Real* pold = (*old_data)[mfi].dataPtr();
+        float* pinc = (*old_incr)[mfi].dataPtr();
+        const long n = (*old_incr)[mfi].box().numPts() * ncomp;
+        for (long i = 0; i < n; ++i) {
+            pinc[i] = static_cast<float>(pnew[i] - pold[i]);
+        }
+    }
+
+    delete old_data;
+    old_data = 0;
+}
+
+void
+StateData::expandOldData ()
+{
+    BL_PROFILE("StateData::expandOldData()");
+
+    if (!old_incr) return;
+
+    BL_ASSERT(old_data == 0);
+    BL_ASSERT(new_data != 0);
+
+    old_data = new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory);
+    buildOldData(*old_data, *new_data, *old_incr, 1.0);
+
+    old_incr.reset();
+}
+
+void
+StateData::buildOldData (MultiFab& dst, const MultiFab& newmf,
+                         const FabArray<BaseFab<float> >& incr, Real w)
+{
+    const int ncomp = dst.nComp();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+    {
+        BL_ASSERT(dst[mfi].box() == incr[mfi].box());
+        const Real* pnew = newmf[mfi].dataPtr();
+        const float* pinc = incr[mfi].dataPtr();
+        Real* pdst = dst[mfi].dataPtr();
+        const long n = dst[mfi].box().numPts() * ncomp;
+        for (long i = 0; i < n; ++i) {
+            pdst[i] = pnew[i] - w*static_cast<Real>(pinc[i]);
+        }
+    }
+}
+
 void
 StateData::FillBoundary (FArrayBox&     dest,
                          Real           time,
@@ -524,6 +636,7 @@ void
 StateData::RegisterData (MultiFabCopyDescriptor& multiFabCopyDesc,
                          Vector<MultiFabId>&      mfid)
 {
+    if (old_incr) expandOldData();
     mfid.resize(2);
     mfid[MFNEWDATA] = multiFabCopyDesc.RegisterFabArray(new_data);
     mfid[MFOLDDATA] = multiFabCopyDesc.RegisterFabArray(old_data);
@@ -662,9 +775,30 @@ void
 StateData::getData (Vector<MultiFab*>& data,
 		    Vector<Real>& datatime,
 		    Real time) const
+{
+    TimeIncrement incr;
+    getData(data, datatime, incr, time);
+    if (incr) {
+        amrex::Abort("StateData::getData: the old data are a compact time history; "
+                     "use the getData that returns the TimeIncrement or expandOldData");
+    }
+}
+
+void
+StateData::getData (Vector<MultiFab*>& data,
+		    Vector<Real>& datatime,
+		    TimeIncrement& incr,
+		    Real time) const
 {
     data.clear();
     datatime.clear();
+    incr = TimeIncrement();
+
+    if (old_incr)
+    {
+        getCompactData(data, datatime, incr, time);
+        return;
+    }
 
     if (desc->timeType() == StateDescriptor::Point)
     {
@@ -714,6 +848,52 @@ StateData::getData (Vector<MultiFab*>& data,
     }
 }
 
+void
+StateData::getCompactData (Vector<MultiFab*>& data,
+                           Vector<Real>& datatime,
+                           TimeIncrement& incr,
+                           Real time) const
+{
+    BL_ASSERT(new_data != 0);
+
+    const Real teps = (new_time.start - old_time.start)*1.e-3;
+
+    if (desc->timeType() == StateDescriptor::Point)
+    {
+        if (time > new_time.start-teps && time < new_time.start+teps) {
+            data.push_back(new_data);
+        } else {
+            //
+            // old + alpha*(new-old) = new - (1-alpha)*incr
+            //
+            const Real alpha = (time - old_time.start) / (new_time.start - old_time.start);
+            data.push_back(new_data);
+            incr.incr   = old_incr.get();
+            incr.weight = 1.0-alpha;
+        }
+        datatime.push_back(time);
+    }
+    else
+    {
+        if (time > new_time.start-teps && time < new_time.stop+teps)
+        {
+            data.push_back(new_data);
+            datatime.push_back(time);
+        }
+        else if (time > old_time.start-teps && time < old_time.stop+teps)
+        {
+            data.push_back(new_data);
+            datatime.push_back(time);
+            incr.incr   = old_incr.get();
+            incr.weight = 1.0;
+        }
+        else
+        {
+            amrex::Error("StateData::getData(): how did we get here?");
+        }
+    }
+}
+
 void
 StateData::checkPoint (const std::string& name,
                        const std::string& fullpathname,
@@ -725,7 +905,7 @@ StateData::checkPoint (const std::string& name,
     static const std::string NewSuffix("_New_MF");
     static const std::string OldSuffix("_Old_MF");
 
-    if (dump_old == true && old_data == 0)
+    if (dump_old == true && !hasOldData())
     {
         dump_old = false;
     }
@@ -775,9 +955,18 @@ StateData::checkPoint (const std::string& name,
 
        if (dump_old)
        {
-           BL_ASSERT(old_data);
            std::string mf_fullpath_old(fullpathname + OldSuffix);
-           VisMF::Write(*old_data,mf_fullpath_old,how);
+           if (old_incr)
+           {
+               MultiFab old_mf(grids,dmap,desc->nComp(),desc->nExtra(),MFInfo(),*m_factory);
+               buildOldData(old_mf, *new_data, *old_incr, 1.0);
+               VisMF::Write(old_mf,mf_fullpath_old,how);
+           }
+           else
+           {
+               BL_ASSERT(old_data);
+               VisMF::Write(*old_data,mf_fullpath_old,how);
+           }
        }
     }
 }
@@ -7,6 +7,7 @@
 
 #ifdef USE_PARTICLES
 #include <AMReX_AmrParGDB.H>
+#include <AMReX_LoadBalanceKD.H>
 #endif
 
 #ifdef _OPENMP
@@ -61,6 +62,11 @@ AmrCore::InitAmrCore ()
     
 #ifdef USE_PARTICLES
     m_gdb.reset(new AmrParGDB(this));
+
+    use_kd_load_balance = false;
+    kd_cell_weight      = 1.0;
+    pp.query("use_kd_load_balance", use_kd_load_balance);
+    pp.query("kd_cell_weight",      kd_cell_weight);
 #endif
 }
 
@@ -79,13 +85,37 @@ AmrCore::regrid (int lbase, Real time, bool)
 
     BL_ASSERT(new_finest <= finest_level+1);
 
-    for (int lev = lbase+1; lev <= new_finest; ++lev)
+    int lmin = lbase+1;
+
+#ifdef USE_PARTICLES
+    //
+    // The KD-tree balancer may also rebalance the base level, since it
+    // only rearranges the cells of a level and does not change nesting.
+    //
+    if (use_kd_load_balance && lbase == 0) {
+        new_grids[0] = grids[0];
+        lmin = 0;
+    }
+#endif
+
+    for (int lev = lmin; lev <= new_finest; ++lev)
     {
+        DistributionMapping new_dmap;
+        bool new_dmap_defined = false;
+
+#ifdef USE_PARTICLES
+        if (use_kd_load_balance) {
+            MakeKDGrids(lev, time, new_grids[lev], new_dmap);
+            new_dmap_defined = true;
+        }
+#endif
+
 	if (lev <= finest_level) // an old level
 	{
-	    if (new_grids[lev] != grids[lev]) // otherwise nothing
+	    if (new_grids[lev] != grids[lev] ||
+                (new_dmap_defined && new_dmap != dmap[lev])) // otherwise nothing
 	    {
-		DistributionMapping new_dmap(new_grids[lev]);
+		if (!new_dmap_defined) new_dmap.define(new_grids[lev]);
 		RemakeLevel(lev, time, new_grids[lev], new_dmap);
 		SetBoxArray(lev, new_grids[lev]);
 		SetDistributionMap(lev, new_dmap);
@@ -93,7 +123,7 @@ AmrCore::regrid (int lbase, Real time, bool)
 	}
 	else  // a new level
 	{
-	    DistributionMapping new_dmap(new_grids[lev]);
+	    if (!new_dmap_defined) new_dmap.define(new_grids[lev]);
 	    MakeNewLevelFromCoarse(lev, time, new_grids[lev], new_dmap);
 	    SetBoxArray(lev, new_grids[lev]);
 	    SetDistributionMap(lev, new_dmap);
@@ -109,6 +139,39 @@ AmrCore::regrid (int lbase, Real time, bool)
     finest_level = new_finest;
 }
 
+#ifdef USE_PARTICLES
+void
+AmrCore::ComputeLoadBalanceCost (int lev, Real time, MultiFab& cost)
+{
+    cost.setVal(kd_cell_weight);
+}
+
+void
+AmrCore::MakeKDGrids (int lev, Real time, BoxArray& ba, DistributionMapping& dm)
+{
+    BL_PROFILE("AmrCore::MakeKDGrids()");
+
+    MultiFab cost(ba, DistributionMapping(ba), 1, 0);
+    ComputeLoadBalanceCost(lev, time, cost);
+
+    const IntVect& bf = blockingFactor(lev);
+    if (!ba.coarsenable(bf)) {
+        amrex::Abort("AmrCore::MakeKDGrids: the grids of level " + std::to_string(lev)
+                     + " are not coarsenable by blocking_factor; the KD-tree balancer"
+                     + " works on blocking_factor blocks");
+    }
+
+    BoxArray new_ba;
+    loadBalanceKD::balanceLevel(cost, bf, maxGridSize(lev), ParallelDescriptor::NProcs(),
+                                new_ba, dm);
+
+    // Keep the BoxArray we were given if it is unchanged, so that the
+    // regrid can tell that only the DistributionMapping is new.
+    if (new_ba != ba) {
+        ba = new_ba;
+    }
+}
+#endif
 
 void
 AmrCore::printGridSummary (std::ostream& os, int min_lev, int max_lev) const
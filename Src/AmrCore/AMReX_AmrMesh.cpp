@@ -61,6 +61,7 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in, std::vecto
     use_fixed_upto_level   = 0;
     refine_grid_layout     = true;
     check_input            = true;
+    sparse_tags            = false;
     
     ParmParse pp("amr");
 
@@ -316,6 +317,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in, std::vecto
 
     pp.query("check_input", check_input);
 
+    pp.query("sparse_tags", sparse_tags);
+
     finest_level = -1;
 
     if (check_input) checkInput();
@@ -576,6 +579,14 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
             tags.setVal(baF,TagBox::SET);
         }
         //
+        // Typically only a small fraction of the cells are tagged.  With
+        // sparse_tags the rest of the tag processing works on runs of
+        // tagged cells instead of on a char per cell.
+        //
+        if (sparse_tags) {
+            tags.makeSparse();
+        }
+        //
         // Buffer error cells.
         //
         tags.buffer(n_error_buf[levc]+ngrow);
@@ -606,9 +617,15 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         }
         //
         // Remove or add tagged points which violate/satisfy additional 
-        // user-specified criteria.
+        // user-specified criteria.  This works on the cell values, but
+        // the tags have been coarsened by the blocking factor, so
+        // switching back and forth is cheap.
         //
+        tags.makeDense();
 	ManualTagsPlacement(levc, tags, bf_lev);
+        if (sparse_tags) {
+            tags.makeSparse();
+        }
         //
         // Map tagged points through periodic boundaries, if any.
         //
@@ -3,6 +3,7 @@
 #include <AMReX_FillPatchUtil_F.H>
 #include <cmath>
 #include <limits>
+#include <algorithm>
 
 #ifdef AMREX_USE_EB
 #include <AMReX_EBFabFactory.H>
@@ -40,10 +41,93 @@ namespace amrex
 	return crse_box.contains(fine_box_coarsened);
     }
 
+    namespace
+    {
+        // dst = src - w*inc on bx.  src may be dst.
+        void
+        subtractIncrement (FArrayBox& dst, int dcomp, const FArrayBox& src, int scomp,
+                           const BaseFab<float>& inc, int icomp, Real w,
+                           const Box& bx, int ncomp)
+        {
+            const Box& dbox = dst.box();
+            const Box& sbox = src.box();
+            const Box& ibox = inc.box();
+
+            const int nx = bx.length(0);
+            Box cols(bx);
+            cols.setBig(0, bx.smallEnd(0));
+
+            for (int n = 0; n < ncomp; ++n)
+            {
+                Real*        pd = dst.dataPtr(dcomp+n);
+                const Real*  ps = src.dataPtr(scomp+n);
+                const float* pi = inc.dataPtr(icomp+n);
+                for (IntVect iv = cols.smallEnd(); iv <= cols.bigEnd(); cols.next(iv))
+                {
+                    Real*        d = pd + dbox.index(iv);
+                    const Real*  s = ps + sbox.index(iv);
+                    const float* c = pi + ibox.index(iv);
+                    for (int i = 0; i < nx; ++i) {
+                        d[i] = s[i] - w*static_cast<Real>(c[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    void
+    TimeIncrement::apply (FArrayBox& dst, int dcomp, const FArrayBox& src, int scomp,
+                          const MFIter& mfi, const Box& bx, int ncomp) const
+    {
+        subtractIncrement(dst, dcomp, src, scomp, (*incr)[mfi], scomp, weight, bx, ncomp);
+    }
+
+    void
+    TimeIncrement::copy (MultiFab& mf, const MultiFab& smf, int scomp, int dcomp, int ncomp,
+                         int ngrow, const Periodicity& period) const
+    {
+        BL_ASSERT(smf.boxArray() == incr->boxArray());
+        BL_ASSERT(smf.DistributionMap() == incr->DistributionMap());
+
+        if (mf.boxArray() == smf.boxArray() && mf.DistributionMap() == smf.DistributionMap())
+        {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+            {
+                apply(mf[mfi], dcomp, smf[mfi], scomp, mfi, mfi.tilebox(), ncomp);
+            }
+            if (ngrow > 0) {
+                mf.FillBoundary(dcomp, ncomp, period);
+            }
+        }
+        else
+        {
+            // Only the increments of the boxes of mf are brought over.
+            mf.copy(smf, scomp, dcomp, ncomp, 0, ngrow, period);
+
+            FabArray<BaseFab<float> > ipatch(mf.boxArray(), mf.DistributionMap(), ncomp, ngrow);
+            ipatch.setVal(0.0);
+            ipatch.copy(*incr, scomp, 0, ncomp, 0, ngrow, period);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+            {
+                FArrayBox& fab = mf[mfi];
+                subtractIncrement(fab, dcomp, fab, dcomp, ipatch[mfi], 0, weight,
+                                  mfi.growntilebox(ngrow), ncomp);
+            }
+        }
+    }
+
     void FillPatchSingleLevel (MultiFab& mf, Real time, 
 			       const Vector<MultiFab*>& smf, const Vector<Real>& stime,
 			       int scomp, int dcomp, int ncomp,
-			       const Geometry& geom, PhysBCFunctBase& physbcf)
+			       const Geometry& geom, PhysBCFunctBase& physbcf,
+			       const TimeIncrement& sinc)
     {
 	BL_PROFILE("FillPatchSingleLevel");
 
@@ -51,8 +135,13 @@ namespace amrex
 	BL_ASSERT(dcomp+ncomp <= mf.nComp());
 	BL_ASSERT(smf.size() == stime.size());
 	BL_ASSERT(smf.size() != 0);
+	BL_ASSERT(!sinc || smf.size() == 1);
 
-	if (smf.size() == 1) 
+	if (sinc)
+	{
+	    sinc.copy(mf, *smf[0], scomp, dcomp, ncomp, mf.nGrow(), geom.periodicity());
+	}
+	else if (smf.size() == 1) 
 	{
 	    mf.copy(*smf[0], scomp, dcomp, ncomp, 0, mf.nGrow(), geom.periodicity());
 	} 
@@ -299,6 +388,242 @@ namespace amrex
 	fbc.FillBoundary(mf, dcomp, ncomp, time);
     }
 
+    void
+    FillPatchPlan::clear ()
+    {
+        for (auto& p : m_crse_patch) {
+            p.clear();
+        }
+        m_interp_boxes.clear();
+        m_dst_boxes.clear();
+        m_fine_ba = BoxArray();
+        m_mapper = nullptr;
+    }
+
+    void
+    FillPatchPlan::definePatch (int i, const FabArrayBase::FPinfo& fpc, int ncomp)
+    {
+        MultiFab& p = m_crse_patch[i];
+        if (p.empty() || p.nComp() < ncomp
+            || p.boxArray() != fpc.ba_crse_patch
+            || p.DistributionMap() != fpc.dm_crse_patch)
+        {
+            // Keep the largest number of components asked for, so that fills
+            // of different component ranges do not reallocate.
+            const int nc = p.empty() ? ncomp : std::max(ncomp, p.nComp());
+            p.clear();
+            p.define(fpc.ba_crse_patch, fpc.dm_crse_patch, nc, 0, MFInfo(),
+                     *fpc.fact_crse_patch);
+        }
+    }
+
+    void
+    FillPatchPlan::buildInterpBoxes (const FabArrayBase::FPinfo& fpc, const BoxArray& fba,
+                                     const Geometry& fgeom)
+    {
+        const std::vector<IntVect>& pshifts = fgeom.periodicity().shiftIntVect();
+        const int N = fpc.dst_boxes.size();
+
+        m_interp_boxes.clear();
+        m_interp_boxes.resize(N);
+
+        for (int li = 0; li < N; ++li)
+        {
+            BoxList bl(fpc.dst_boxes[li]);
+            for (const auto& iv : pshifts)
+            {
+                if (iv == IntVect::TheZeroVector()) continue;
+                BoxList leftover(bl.ixType());
+                for (const Box& b : bl)
+                {
+                    const BoxList& r = fba.complementIn(b+iv);
+                    for (const Box& rb : r) {
+                        leftover.push_back(rb-iv);
+                    }
+                }
+                bl = std::move(leftover);
+            }
+            m_interp_boxes[li] = std::move(bl);
+        }
+
+        m_dst_boxes = fpc.dst_boxes;
+        m_fine_ba = fba;
+    }
+
+    void
+    FillPatchPlan::FillFromCoarseLevel (MultiFab& mf, int ngrow, Real time,
+                                        const Vector<MultiFab*>& cmf, const Vector<Real>& ct,
+                                        const MultiFab& fine,
+                                        int scomp, int dcomp, int ncomp,
+                                        const Geometry& cgeom, const Geometry& fgeom,
+                                        PhysBCFunctBase& cbc, const IntVect& ratio,
+                                        Interpolater* mapper, const Vector<BCRec>& bcs,
+                                        const TimeIncrement& cinc)
+    {
+	BL_PROFILE("FillPatchPlan::FillFromCoarseLevel");
+
+	BL_ASSERT(ngrow <= mf.nGrow());
+	BL_ASSERT(!cinc || ct.size() == 1);
+
+	if (ct.size() > 2) {
+	    amrex::Abort("FillPatchPlan: high-order interpolation in time not implemented yet");
+	}
+
+	if (ngrow > 0 || mf.getBDKey() != fine.getBDKey())
+	{
+	    const InterpolaterBoxCoarsener& coarsener = mapper->BoxCoarsener(ratio);
+
+	    Box fdomain = fgeom.Domain();
+	    fdomain.convert(mf.boxArray().ixType());
+	    Box fdomain_g(fdomain);
+	    for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+		if (fgeom.isPeriodic(i)) {
+		    fdomain_g.grow(i,ngrow);
+		}
+	    }
+
+	    const FabArrayBase::FPinfo& fpc = FabArrayBase::TheFPinfo(fine, mf, fdomain_g,
+                                                                      ngrow, coarsener,
+                                                                      amrex::coarsen(fgeom.Domain(),ratio));
+
+	    if ( ! fpc.ba_crse_patch.empty())
+	    {
+		// Coarse time levels that contribute.
+		int it0 = 0, it1 = -1;
+		if (ct.size() == 2 && ct[0] != ct[1]) {
+		    if (time == ct[1]) {
+			it0 = 1;
+		    } else if (time != ct[0]) {
+			it1 = 1;
+		    }
+		}
+
+		for (int it : {it0, it1})
+		{
+		    if (it < 0) continue;
+		    const int i = (it == it0) ? 0 : 1;
+		    definePatch(i, fpc, ncomp);
+		    m_crse_patch[i].setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), 0, ncomp, cgeom);
+		    if (cinc) {
+			cinc.copy(m_crse_patch[i], *cmf[it], scomp, 0, ncomp, 0, cgeom.periodicity());
+		    } else {
+			m_crse_patch[i].copy(*cmf[it], scomp, 0, ncomp, cgeom.periodicity());
+		    }
+		    cbc.FillBoundary(m_crse_patch[i], 0, ncomp, ct[it]);
+		}
+
+		if (m_mapper != mapper || m_ratio != ratio
+		    || m_dst_boxes != fpc.dst_boxes || m_fine_ba != fine.boxArray())
+		{
+		    buildInterpBoxes(fpc, fine.boxArray(), fgeom);
+		    m_mapper = mapper;
+		    m_ratio = ratio;
+		}
+
+		int idummy1=0, idummy2=0;
+		bool cc = fpc.ba_crse_patch.ixType().cellCentered();
+                ignore_unused(cc);
+#ifdef _OPENMP
+#pragma omp parallel if (cc)
+#endif
+		{
+		    Vector<BCRec> bcr(ncomp);
+
+		    for (MFIter mfi(m_crse_patch[0]); mfi.isValid(); ++mfi)
+		    {
+			int li = mfi.LocalIndex();
+			int gi = fpc.dst_idxs[li];
+			const Box& dbx = fpc.dst_boxes[li];
+
+			FArrayBox& cfab = m_crse_patch[0][mfi];
+			if (it1 >= 0) {
+			    cfab.linInterp(cfab, 0, m_crse_patch[1][mfi], 0,
+					   ct[it0], ct[it1], time, cfab.box(), 0, ncomp);
+			}
+
+			amrex::setBC(dbx,fdomain,scomp,0,ncomp,bcs,bcr);
+
+			for (const Box& ibx : m_interp_boxes[li])
+			{
+			    mapper->interp(cfab,
+					   0,
+					   mf[gi],
+					   dcomp,
+					   ncomp,
+					   ibx,
+					   ratio,
+					   cgeom,
+					   fgeom,
+					   bcr,
+					   idummy1, idummy2);
+			}
+		    }
+		}
+	    }
+	}
+    }
+
+    void
+    FillPatchPlan::FillPatchTwoLevels (MultiFab& mf, Real time,
+                                       const Vector<MultiFab*>& cmf, const Vector<Real>& ct,
+                                       const Vector<MultiFab*>& fmf, const Vector<Real>& ft,
+                                       int scomp, int dcomp, int ncomp,
+                                       const Geometry& cgeom, const Geometry& fgeom,
+                                       PhysBCFunctBase& cbc, PhysBCFunctBase& fbc,
+                                       const IntVect& ratio,
+                                       Interpolater* mapper, const Vector<BCRec>& bcs,
+                                       const TimeIncrement& cinc, const TimeIncrement& finc)
+    {
+	BL_PROFILE("FillPatchPlan::FillPatchTwoLevels");
+
+	BL_ASSERT(cmf.size() == ct.size() && fmf.size() == ft.size());
+
+	if (ct.size() > 2 || ft.size() > 2) {
+	    amrex::Abort("FillPatchPlan: high-order interpolation in time not implemented yet");
+	}
+
+	int ngrow = mf.nGrow();
+
+	// The fine data go straight into mf when they live on the same grids,
+	// and the ghost cells covered by fine grids are exchanged while the
+	// coarse data are being copied.
+	const bool sameba = mf.boxArray() == fmf[0]->boxArray()
+	    && mf.DistributionMap() == fmf[0]->DistributionMap();
+
+	if (sameba)
+	{
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	    for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+	    {
+		const Box& bx = mfi.tilebox();
+		if (finc) {
+		    finc.apply(mf[mfi], dcomp, (*fmf[0])[mfi], scomp, mfi, bx, ncomp);
+		} else if (fmf.size() == 1) {
+		    mf[mfi].copy((*fmf[0])[mfi], bx, scomp, bx, dcomp, ncomp);
+		} else {
+		    mf[mfi].linInterp((*fmf[0])[mfi], scomp, (*fmf[1])[mfi], scomp,
+				      ft[0], ft[1], time, bx, dcomp, ncomp);
+		}
+	    }
+	    mf.FillBoundary_nowait(dcomp, ncomp, fgeom.periodicity());
+	}
+
+	FillFromCoarseLevel(mf, ngrow, time, cmf, ct, *fmf[0], scomp, dcomp, ncomp,
+			    cgeom, fgeom, cbc, ratio, mapper, bcs, cinc);
+
+	if (sameba)
+	{
+	    mf.FillBoundary_finish();
+	    fbc.FillBoundary(mf, dcomp, ncomp, time);
+	}
+	else
+	{
+	    FillPatchSingleLevel(mf, time, fmf, ft, scomp, dcomp, ncomp, fgeom, fbc, finc);
+	}
+    }
+
     // B fields are assumed to be on staggered grids.
     void InterpCrseFineBndryEMfield (InterpEM_t interp_type,
                                      const std::array<MultiFab,AMREX_SPACEDIM>& crse,
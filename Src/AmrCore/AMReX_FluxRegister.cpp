@@ -7,6 +7,8 @@
 #include <AMReX_ccse-mpi.H>
 
 #include <vector>
+#include <map>
+#include <limits>
 
 namespace amrex {
 
@@ -90,10 +92,16 @@ FluxRegister::define (const BoxArray&            fine_boxes,
 void
 FluxRegister::clear ()
 {
+    CrseInitCancel();
+    RefluxCancel();
     BndryRegister::clear();
 }
 
-FluxRegister::~FluxRegister () {}
+FluxRegister::~FluxRegister ()
+{
+    CrseInitCancel();
+    RefluxCancel();
+}
 
 Real
 FluxRegister::SumReg (int comp) const
@@ -129,11 +137,36 @@ FluxRegister::CrseInit (const MultiFab& mflx,
                         Real            mult,
                         FrOp            op)
 {
+    BL_PROFILE("FluxRegister::CrseInit()");
+
+    CrseInit_nowait(mflx,area,dir,srccomp,destcomp,numcomp,mult,op);
+    CrseInit_finish();
+}
+
+void
+FluxRegister::CrseInit_nowait (const MultiFab& mflx,
+                               const MultiFab& area,
+                               int             dir,
+                               int             srccomp,
+                               int             destcomp,
+                               int             numcomp,
+                               Real            mult,
+                               FrOp            op)
+{
+    BL_PROFILE("FluxRegister::CrseInit_nowait()");
+
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= mflx.nComp());
     BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= ncomp);
 
-    const Orientation face_lo(dir,Orientation::low);
-    const Orientation face_hi(dir,Orientation::high);
+    for (auto const& ci : m_crseinit_pending) {
+        if (ci.dir == dir) {
+            CrseInit_finish();
+            break;
+        }
+    }
+
+    const Orientation faces[2] = {Orientation(dir,Orientation::low),
+                                  Orientation(dir,Orientation::high)};
  
     MultiFab mf(mflx.boxArray(),mflx.DistributionMap(),numcomp,0,
                 MFInfo(), mflx.Factory());
@@ -154,29 +187,224 @@ FluxRegister::CrseInit (const MultiFab& mflx,
             mf[mfi].mult(area[mfi],bx,bx,0,i,1);
     }
 
-    for (int pass = 0; pass < 2; pass++)
+    if (!(m_crseinit_ba[dir] == mf.boxArray() && m_crseinit_dm[dir] == mf.DistributionMap()))
     {
-        const Orientation face = ((pass == 0) ? face_lo : face_hi);
+        for (const Orientation& face : faces) {
+            m_crseinit_cpc[face].reset();
+        }
+        m_crseinit_ba[dir] = mf.boxArray();
+        m_crseinit_dm[dir] = mf.DistributionMap();
+    }
+
+    for (const Orientation& face : faces)
+    {
+        if (!m_crseinit_cpc[face])
+        {
+            const FabSet& fs = bndry[face];
+            Vector<int> fs_idx;
+            for (FabSetIter fsi(fs); fsi.isValid(); ++fsi) {
+                fs_idx.push_back(fsi.index());
+            }
+            m_crseinit_cpc[face].reset(new FabArrayBase::CPC(fs.boxArray(), fs.DistributionMap(),
+                                                             fs_idx, 0,
+                                                             mf.boxArray(), mf.DistributionMap(),
+                                                             mf.IndexArray(), 0,
+                                                             Periodicity::NonPeriodic(),
+                                                             ParallelDescriptor::MyProc()));
+        }
+    }
 
-        if (op == FluxRegister::COPY)
+    m_crseinit_pending.push_back(CrseInitMsgs());
+    CrseInitMsgs& ci = m_crseinit_pending.back();
+    ci.dir   = dir;
+    ci.dcomp = destcomp;
+    ci.nc    = numcomp;
+    ci.op    = op;
+
+    if (op == FluxRegister::ADD)
+    {
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const FabSet& fs = bndry[faces[pass]];
+            ci.fs[pass].reset(new FabSet(fs.boxArray(),fs.DistributionMap(),numcomp));
+            ci.fs[pass]->setVal(0);
+        }
+    }
+
+#ifdef BL_USE_MPI
+    if (ParallelDescriptor::NProcs() > 1)
+    {
+        //
+        // Everybody gets a sequence number, even with nothing to send.
+        //
+        const int SeqNum = ParallelDescriptor::SeqNum();
+        //
+        // Message sizes per rank, summed over the two faces.
+        //
+        std::map<int,std::size_t> send_bytes, recv_bytes;
+        for (const Orientation& face : faces)
+        {
+            const FabArrayBase::CPC& cpc = *m_crseinit_cpc[face];
+            for (auto const& kv : *cpc.m_SndTags) {
+                for (auto const& tag : kv.second) {
+                    send_bytes[kv.first] += mf[tag.srcIndex].nBytes(tag.sbox,0,numcomp);
+                }
+            }
+            for (auto const& kv : *cpc.m_RcvTags) {
+                for (auto const& tag : kv.second) {
+                    recv_bytes[kv.first] += tag.dbox.numPts()*numcomp*sizeof(Real);
+                }
+            }
+        }
+
+        for (auto const& kv : recv_bytes)
+        {
+            if (kv.second == 0) continue;
+            BL_ASSERT(kv.second < std::numeric_limits<int>::max());
+            char* data = static_cast<char*>(amrex::The_Arena()->alloc(kv.second));
+            ci.recv_data.push_back(data);
+            ci.recv_from.push_back(kv.first);
+            ci.recv_reqs.push_back(ParallelDescriptor::Arecv(data, kv.second,
+                                                             kv.first, SeqNum).req());
+        }
+
+        for (auto const& kv : send_bytes)
+        {
+            if (kv.second == 0) continue;
+            BL_ASSERT(kv.second < std::numeric_limits<int>::max());
+            char* data = static_cast<char*>(amrex::The_Arena()->alloc(kv.second));
+            char* dptr = data;
+            for (const Orientation& face : faces)
+            {
+                const auto& snd = *m_crseinit_cpc[face]->m_SndTags;
+                auto it = snd.find(kv.first);
+                if (it == snd.end()) continue;
+                for (auto const& tag : it->second) {
+                    dptr += mf[tag.srcIndex].copyToMem(tag.sbox,0,numcomp,dptr);
+                }
+            }
+            BL_ASSERT(dptr == data + kv.second);
+            ci.send_data.push_back(data);
+            ci.send_reqs.push_back(ParallelDescriptor::Asend(data, kv.second,
+                                                             kv.first, SeqNum).req());
+        }
+    }
+#endif
+
+    //
+    // The local part, while the messages are in flight.
+    //
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const FabArrayBase::CPC& cpc = *m_crseinit_cpc[faces[pass]];
+        FabSet& fs = (op == FluxRegister::COPY) ? bndry[faces[pass]] : *ci.fs[pass];
+        const int dcomp = (op == FluxRegister::COPY) ? destcomp : 0;
+        const int N_loc = cpc.m_LocTags->size();
+#ifdef _OPENMP
+#pragma omp parallel for if (cpc.m_threadsafe_loc)
+#endif
+        for (int i = 0; i < N_loc; ++i)
         {
-            bndry[face].copyFrom(mf,0,0,destcomp,numcomp);
+            const FabArrayBase::CopyComTag& tag = (*cpc.m_LocTags)[i];
+            fs[tag.dstIndex].copy(mf[tag.srcIndex],tag.sbox,0,tag.dbox,dcomp,numcomp);
         }
-        else
+    }
+}
+
+void
+FluxRegister::CrseInit_nowait (const MultiFab& mflx,
+                               int             dir,
+                               int             srccomp,
+                               int             destcomp,
+                               int             numcomp,
+                               Real            mult,
+                               FrOp            op)
+{
+    MultiFab area(mflx.boxArray(), mflx.DistributionMap(), 1, mflx.nGrow(),
+                  MFInfo(), mflx.Factory());
+
+    area.setVal(1, 0, 1, area.nGrow());
+
+    CrseInit_nowait(mflx,area,dir,srccomp,destcomp,numcomp,mult,op);
+}
+
+void
+FluxRegister::CrseInit_finish ()
+{
+    if (m_crseinit_pending.empty()) return;
+
+    BL_PROFILE("FluxRegister::CrseInit_finish()");
+
+    for (CrseInitMsgs& ci : m_crseinit_pending)
+    {
+        const Orientation faces[2] = {Orientation(ci.dir,Orientation::low),
+                                      Orientation(ci.dir,Orientation::high)};
+
+#ifdef BL_USE_MPI
+        const int dcomp = (ci.op == FluxRegister::COPY) ? ci.dcomp : 0;
+
+        if (!ci.recv_reqs.empty())
         {
-            FabSet fs(bndry[face].boxArray(),bndry[face].DistributionMap(),numcomp);
+            Vector<MPI_Status> stats(ci.recv_reqs.size());
+            ParallelDescriptor::Waitall(ci.recv_reqs, stats);
+        }
 
-            fs.setVal(0);
+        for (int j = 0, N = ci.recv_data.size(); j < N; ++j)
+        {
+            const char* dptr = ci.recv_data[j];
+            const int rank = ci.recv_from[j];
+            for (int pass = 0; pass < 2; pass++)
+            {
+                const auto& rcv = *m_crseinit_cpc[faces[pass]]->m_RcvTags;
+                auto it = rcv.find(rank);
+                if (it == rcv.end()) continue;
+                FabSet& fs = (ci.op == FluxRegister::COPY) ? bndry[faces[pass]] : *ci.fs[pass];
+                for (auto const& tag : it->second) {
+                    dptr += fs[tag.dstIndex].copyFromMem(tag.dbox,dcomp,ci.nc,dptr);
+                }
+            }
+            amrex::The_Arena()->free(ci.recv_data[j]);
+        }
 
-            fs.copyFrom(mf,0,0,0,numcomp);
+        if (!ci.send_reqs.empty())
+        {
+            Vector<MPI_Status> stats(ci.send_reqs.size());
+            ParallelDescriptor::Waitall(ci.send_reqs, stats);
+        }
+        for (char* p : ci.send_data) {
+            amrex::The_Arena()->free(p);
+        }
+#endif
 
+        if (ci.op == FluxRegister::ADD)
+        {
+            for (int pass = 0; pass < 2; pass++)
+            {
+                const FabSet& fs = *ci.fs[pass];
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-            for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
-                bndry[face][mfi].plus(fs[mfi],0,destcomp,numcomp);
+                for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
+                    bndry[faces[pass]][mfi].plus(fs[mfi],0,ci.dcomp,ci.nc);
+            }
         }
     }
+
+    m_crseinit_pending.clear();
+}
+
+void
+FluxRegister::CrseInitCancel ()
+{
+    CrseInit_finish();
+
+    for (auto& cpc : m_crseinit_cpc) {
+        cpc.reset();
+    }
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        m_crseinit_ba[dir] = BoxArray();
+        m_crseinit_dm[dir] = DistributionMapping();
+    }
 }
 
 void
@@ -212,6 +440,8 @@ FluxRegister::CrseAdd (const MultiFab& mflx,
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= mflx.nComp());
     BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= ncomp);
 
+    CrseInit_finish();
+
     const Orientation face_lo(dir,Orientation::low);
     const Orientation face_hi(dir,Orientation::high);
  
@@ -308,6 +538,7 @@ FluxRegister::FineAdd (const FArrayBox& flux,
 {
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= flux.nComp());
     BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= ncomp);
+    BL_ASSERT(!CrseInitPending());
 
     const Box&  flxbox = flux.box();
     const int*  flo    = flxbox.loVect();
@@ -352,6 +583,7 @@ FluxRegister::FineAdd (const FArrayBox& flux,
 {
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= flux.nComp());
     BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= ncomp);
+    BL_ASSERT(!CrseInitPending());
 
     const Real* area_dat = area.dataPtr();
     const int*  alo      = area.loVect();
@@ -400,17 +632,267 @@ FluxRegister::Reflux (MultiFab&       mf,
 {
     BL_PROFILE("FluxRegister::Reflux()");
 
+    Reflux_nowait(mf,volume,scale,scomp,dcomp,nc,geom);
+    Reflux_finish();
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             const MultiFab& volume,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    BL_PROFILE("FluxRegister::Reflux_nowait()");
+
+    if (m_reflux_pending) {
+        amrex::Abort("FluxRegister::Reflux_nowait: a Reflux is already in flight");
+    }
+
+    CrseInit_finish();
+
+    BL_ASSERT(scomp >= 0 && scomp+nc <= ncomp);
+
+    m_reflux_pending = true;
+    m_reflux_mf      = &mf;
+    m_reflux_vol     = &volume;
+    m_reflux_scale   = scale;
+    m_reflux_dcomp   = dcomp;
+    m_reflux_nc      = nc;
+
+    const Periodicity& period = geom.periodicity();
+
+    if (!(m_reflux_ba == mf.boxArray() && m_reflux_dm == mf.DistributionMap()
+          && m_reflux_period == period))
+    {
+        for (auto& cpc : m_reflux_cpc) {
+            cpc.reset();
+        }
+        m_reflux_ba     = mf.boxArray();
+        m_reflux_dm     = mf.DistributionMap();
+        m_reflux_period = period;
+    }
+
     for (OrientationIter fi; fi; ++fi)
     {
 	const Orientation& face = fi();
-	int idir = face.coordDir();
-	int islo = face.isLow();
+	const int idir = face.coordDir();
 
-        MultiFab flux(amrex::convert(mf.boxArray(), IntVect::TheDimensionVector(idir)),
-                      mf.DistributionMap(), nc, 0, MFInfo(), mf.Factory());
+        MultiFab& flux = m_reflux_flux[face];
+        flux.define(amrex::convert(mf.boxArray(), IntVect::TheDimensionVector(idir)),
+                    mf.DistributionMap(), nc, 0, MFInfo(), mf.Factory());
 	flux.setVal(0.0);
 
-	bndry[face].copyTo(flux, 0, scomp, 0, nc, geom.periodicity());
+        if (!m_reflux_cpc[face])
+        {
+            const FabSet& fs = bndry[face];
+            Vector<int> fs_idx;
+            for (FabSetIter fsi(fs); fsi.isValid(); ++fsi) {
+                fs_idx.push_back(fsi.index());
+            }
+            m_reflux_cpc[face].reset(new FabArrayBase::CPC(flux.boxArray(), flux.DistributionMap(),
+                                                           flux.IndexArray(), 0,
+                                                           fs.boxArray(), fs.DistributionMap(),
+                                                           fs_idx, 0,
+                                                           period, ParallelDescriptor::MyProc()));
+        }
+    }
+
+#ifdef BL_USE_MPI
+    if (ParallelDescriptor::NProcs() > 1)
+    {
+        //
+        // Everybody gets a sequence number, even with nothing to send.
+        //
+        const int SeqNum = ParallelDescriptor::SeqNum();
+        //
+        // Message sizes per rank, summed over the faces.
+        //
+        std::map<int,std::size_t> send_bytes, recv_bytes;
+        for (OrientationIter fi; fi; ++fi)
+        {
+            const Orientation& face = fi();
+            const FabArrayBase::CPC& cpc = *m_reflux_cpc[face];
+            for (auto const& kv : *cpc.m_SndTags) {
+                for (auto const& tag : kv.second) {
+                    send_bytes[kv.first] += bndry[face][tag.srcIndex].nBytes(tag.sbox,scomp,nc);
+                }
+            }
+            for (auto const& kv : *cpc.m_RcvTags) {
+                for (auto const& tag : kv.second) {
+                    recv_bytes[kv.first] += tag.dbox.numPts()*nc*sizeof(Real);
+                }
+            }
+        }
+
+        for (auto const& kv : recv_bytes)
+        {
+            if (kv.second == 0) continue;
+            BL_ASSERT(kv.second < std::numeric_limits<int>::max());
+            char* data = static_cast<char*>(amrex::The_Arena()->alloc(kv.second));
+            m_reflux_recv_data.push_back(data);
+            m_reflux_recv_from.push_back(kv.first);
+            m_reflux_recv_reqs.push_back(ParallelDescriptor::Arecv(data, kv.second,
+                                                                   kv.first, SeqNum).req());
+        }
+
+        for (auto const& kv : send_bytes)
+        {
+            if (kv.second == 0) continue;
+            BL_ASSERT(kv.second < std::numeric_limits<int>::max());
+            char* data = static_cast<char*>(amrex::The_Arena()->alloc(kv.second));
+            char* dptr = data;
+            for (OrientationIter fi; fi; ++fi)
+            {
+                const Orientation& face = fi();
+                const auto& snd = *m_reflux_cpc[face]->m_SndTags;
+                auto it = snd.find(kv.first);
+                if (it == snd.end()) continue;
+                for (auto const& tag : it->second) {
+                    dptr += bndry[face][tag.srcIndex].copyToMem(tag.sbox,scomp,nc,dptr);
+                }
+            }
+            BL_ASSERT(dptr == data + kv.second);
+            m_reflux_send_data.push_back(data);
+            m_reflux_send_reqs.push_back(ParallelDescriptor::Asend(data, kv.second,
+                                                                   kv.first, SeqNum).req());
+        }
+    }
+#endif
+
+    //
+    // The local part, while the messages are in flight.
+    //
+    for (OrientationIter fi; fi; ++fi)
+    {
+	const Orientation& face = fi();
+        const FabArrayBase::CPC& cpc = *m_reflux_cpc[face];
+        MultiFab& flux = m_reflux_flux[face];
+        const FabSet& fs = bndry[face];
+        const int N_loc = cpc.m_LocTags->size();
+#ifdef _OPENMP
+#pragma omp parallel for if (cpc.m_threadsafe_loc)
+#endif
+        for (int i = 0; i < N_loc; ++i)
+        {
+            const FabArrayBase::CopyComTag& tag = (*cpc.m_LocTags)[i];
+            flux[tag.dstIndex].copy(fs[tag.srcIndex],tag.sbox,scomp,tag.dbox,0,nc);
+        }
+    }
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    const Real* dx = geom.CellSize();
+
+    m_reflux_own_vol.reset(new MultiFab(mf.boxArray(), mf.DistributionMap(), 1, mf.nGrow(),
+                                        MFInfo(), mf.Factory()));
+
+    m_reflux_own_vol->setVal(AMREX_D_TERM(dx[0],*dx[1],*dx[2]), 0, 1, mf.nGrow());
+
+    Reflux_nowait(mf,*m_reflux_own_vol,scale,scomp,dcomp,nc,geom);
+}
+
+void
+FluxRegister::RefluxWait ()
+{
+    if (!m_reflux_pending) return;
+
+#ifdef BL_USE_MPI
+    if (!m_reflux_recv_reqs.empty())
+    {
+        Vector<MPI_Status> stats(m_reflux_recv_reqs.size());
+        ParallelDescriptor::Waitall(m_reflux_recv_reqs, stats);
+    }
+    if (!m_reflux_send_reqs.empty())
+    {
+        Vector<MPI_Status> stats(m_reflux_send_reqs.size());
+        ParallelDescriptor::Waitall(m_reflux_send_reqs, stats);
+    }
+    for (char* p : m_reflux_send_data) {
+        amrex::The_Arena()->free(p);
+    }
+#endif
+    m_reflux_send_data.clear();
+    m_reflux_send_reqs.clear();
+    m_reflux_recv_reqs.clear();
+}
+
+void
+FluxRegister::RefluxCancel ()
+{
+    RefluxWait();
+
+    for (char* p : m_reflux_recv_data) {
+        amrex::The_Arena()->free(p);
+    }
+    m_reflux_recv_data.clear();
+    m_reflux_recv_from.clear();
+
+    for (auto& flux : m_reflux_flux) {
+        flux.clear();
+    }
+    for (auto& cpc : m_reflux_cpc) {
+        cpc.reset();
+    }
+    m_reflux_ba = BoxArray();
+    m_reflux_own_vol.reset();
+    m_reflux_mf = nullptr;
+    m_reflux_vol = nullptr;
+    m_reflux_pending = false;
+}
+
+void
+FluxRegister::Reflux_finish ()
+{
+    BL_PROFILE("FluxRegister::Reflux_finish()");
+
+    if (!m_reflux_pending) return;
+
+    RefluxWait();
+
+    const int nc = m_reflux_nc;
+
+    for (int j = 0, N = m_reflux_recv_data.size(); j < N; ++j)
+    {
+        const char* dptr = m_reflux_recv_data[j];
+        const int rank = m_reflux_recv_from[j];
+        for (OrientationIter fi; fi; ++fi)
+        {
+            const Orientation& face = fi();
+            const auto& rcv = *m_reflux_cpc[face]->m_RcvTags;
+            auto it = rcv.find(rank);
+            if (it == rcv.end()) continue;
+            MultiFab& flux = m_reflux_flux[face];
+            for (auto const& tag : it->second) {
+                dptr += flux[tag.dstIndex].copyFromMem(tag.dbox,0,nc,dptr);
+            }
+        }
+        amrex::The_Arena()->free(m_reflux_recv_data[j]);
+    }
+    m_reflux_recv_data.clear();
+    m_reflux_recv_from.clear();
+
+    MultiFab& mf = *m_reflux_mf;
+    const MultiFab& volume = *m_reflux_vol;
+    const int dcomp = m_reflux_dcomp;
+    Real scale = m_reflux_scale;
+
+    for (OrientationIter fi; fi; ++fi)
+    {
+	const Orientation& face = fi();
+	int idir = face.coordDir();
+	int islo = face.isLow();
+
+        const MultiFab& flux = m_reflux_flux[face];
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -436,6 +918,14 @@ FluxRegister::Reflux (MultiFab&       mf,
 			  
 	}
     }
+
+    for (auto& flux : m_reflux_flux) {
+        flux.clear();
+    }
+    m_reflux_own_vol.reset();
+    m_reflux_mf = nullptr;
+    m_reflux_vol = nullptr;
+    m_reflux_pending = false;
 }
 
 void 
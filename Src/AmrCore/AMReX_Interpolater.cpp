@@ -1,10 +1,13 @@
 
 #include <climits>
+#include <cmath>
+#include <algorithm>
 
 #include <AMReX_FArrayBox.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_Interpolater.H>
 #include <AMReX_INTERP_F.H>
+#include <AMReX_BC_TYPES.H>
 
 namespace amrex {
 
@@ -25,8 +28,353 @@ CellConservativeLinear    cell_cons_interp(0);
 CellConservativeProtected protected_interp;
 CellConservativeQuartic   quartic_interp;
 
+bool Interpolater::specialize_ratio = true;
+
 Interpolater::~Interpolater () {}
 
+#if (AMREX_SPACEDIM == 3)
+namespace {
+
+//
+// Strided access to one component of a FAB.
+//
+struct FabView
+{
+    Real* p;
+    int   lo[3];
+    long  jstr, kstr, nstr;
+
+    FabView (const FArrayBox& fab, int comp)
+        : p(const_cast<Real*>(fab.dataPtr(comp))),
+          jstr(fab.box().length(0)),
+          kstr(fab.box().length(0)*long(fab.box().length(1))),
+          nstr(fab.box().numPts())
+    {
+        for (int d = 0; d < 3; ++d) lo[d] = fab.box().smallEnd(d);
+    }
+
+    Real* ptr (int i, int j, int k, int n) const {
+        return p + (i-lo[0]) + (j-lo[1])*jstr + (k-lo[2])*kstr + n*nstr;
+    }
+
+    Real& operator() (int i, int j, int k, int n) const { return *ptr(i,j,k,n); }
+};
+
+//
+// Same as FORT_NBINTERP with lratio = R in every direction.  As there,
+// the fine values are set wherever the fine FAB and the coarse box
+// overlap, not only on fine_region.
+//
+template <int R>
+void
+nbinterp (const FArrayBox& crse, int crse_comp, FArrayBox& fine, int fine_comp, int ncomp)
+{
+    const Real RX   = 1.0/R;
+    const Real RXY  = RX*RX;
+    const Real RXYZ = RX*RX*RX;
+
+    const Box& cb = crse.box();
+    const Box& fb = fine.box();
+
+    const FabView c(crse, crse_comp);
+    const FabView f(fine, fine_comp);
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        for (int kc = cb.smallEnd(2); kc < cb.bigEnd(2); ++kc)
+        {
+            const int kstrt = kc*R;
+            const int kstop = kstrt + ((kc == cb.bigEnd(2)-1) ? R : R-1);
+            const int klo = std::max(fb.smallEnd(2),kstrt) - kstrt;
+            const int khi = std::min(fb.bigEnd(2),kstop) - kstrt;
+
+            for (int jc = cb.smallEnd(1); jc < cb.bigEnd(1); ++jc)
+            {
+                const int jstrt = jc*R;
+                const int jstop = jstrt + ((jc == cb.bigEnd(1)-1) ? R : R-1);
+                const int jlo = std::max(fb.smallEnd(1),jstrt) - jstrt;
+                const int jhi = std::min(fb.bigEnd(1),jstop) - jstrt;
+
+                for (int ic = cb.smallEnd(0); ic < cb.bigEnd(0); ++ic)
+                {
+                    const int istrt = ic*R;
+                    const int istop = istrt + ((ic == cb.bigEnd(0)-1) ? R : R-1);
+                    const int ilo = std::max(fb.smallEnd(0),istrt) - istrt;
+                    const int ihi = std::min(fb.bigEnd(0),istop) - istrt;
+
+                    const Real c000 = c(ic,jc,kc,n);
+                    const Real dx00 = c(ic+1,jc,kc,n) - c000;
+                    const Real d0x0 = c(ic,jc+1,kc,n) - c000;
+                    const Real d00x = c(ic,jc,kc+1,n) - c000;
+                    const Real dx10 = c(ic+1,jc+1,kc,n) - c(ic,jc+1,kc,n);
+                    const Real dx01 = c(ic+1,jc,kc+1,n) - c(ic,jc,kc+1,n);
+                    const Real d0x1 = c(ic,jc+1,kc+1,n) - c(ic,jc,kc+1,n);
+                    const Real dx11 = c(ic+1,jc+1,kc+1,n) - c(ic,jc+1,kc+1,n);
+
+                    const Real sx   = RX*dx00;
+                    const Real sy   = RX*d0x0;
+                    const Real sz   = RX*d00x;
+                    const Real sxy  = RXY*(dx10 - dx00);
+                    const Real sxz  = RXY*(dx01 - dx00);
+                    const Real syz  = RXY*(d0x1 - d0x0);
+                    const Real sxyz = RXYZ*(dx11 - dx01 - dx10 + dx00);
+
+                    for (int koff = klo; koff <= khi; ++koff)
+                    {
+                        const Real fz = koff;
+                        for (int joff = jlo; joff <= jhi; ++joff)
+                        {
+                            const Real fy = joff;
+                            Real* fp = f.ptr(istrt,jc*R+joff,kc*R+koff,n);
+                            if (ilo == 0 && ihi == R-1)
+                            {
+                                for (int ioff = 0; ioff < R; ++ioff)
+                                {
+                                    const Real fx = ioff;
+                                    fp[ioff] = c000 + fx*sx + fy*sy + fz*sz
+                                        + fx*fy*sxy + fx*fz*sxz + fy*fz*syz
+                                        + fx*fy*fz*sxyz;
+                                }
+                            }
+                            else
+                            {
+                                for (int ioff = ilo; ioff <= ihi; ++ioff)
+                                {
+                                    const Real fx = ioff;
+                                    fp[ioff] = c000 + fx*sx + fy*sy + fz*sz
+                                        + fx*fy*sxy + fx*fz*sxz + fy*fz*syz
+                                        + fx*fy*fz*sxyz;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+// Limited slope as in FORT_LINCCINTERP.
+//
+inline Real
+mc_slope (Real cen, Real forw, Real back)
+{
+    Real slp = std::min(std::abs(forw),std::abs(back));
+    if (!(forw*back >= 0.0)) slp = 0.0;
+    return std::copysign(1.0,cen)*std::min(slp,std::abs(cen));
+}
+
+//
+// Same as FORT_LINCCINTERP with lim_slope = 1, lratio = R in every
+// direction and Cartesian coordinates, where the fine cell centers are
+// offset from the coarse one by (ioff+1/2)/R-1/2 coarse cells.
+//
+template <int R>
+void
+linccinterp (const FArrayBox& crse, int crse_comp, FArrayBox& fine, int fine_comp, int ncomp,
+             const Box& fine_region, const Box& cslope_bx, const Vector<BCRec>& bcr,
+             bool lin_limit)
+{
+    Real voff[R];
+    for (int ii = 0; ii < R; ++ii) {
+        voff[ii] = (ii+0.5)/R - 0.5;
+    }
+
+    const FabView c(crse, crse_comp);
+    const FabView f(fine, fine_comp);
+
+    // Unlimited and limited slopes of all components in all directions,
+    // and the alpha limiter.
+    FArrayBox ucfab(cslope_bx, 3*ncomp);
+    FArrayBox lcfab(cslope_bx, 3*ncomp);
+    FArrayBox alfab(cslope_bx, ncomp);
+    const FabView uc(ucfab, 0);
+    const FabView lc(lcfab, 0);
+    const FabView al(alfab, 0);
+
+    const IntVect& slo = cslope_bx.smallEnd();
+    const IntVect& shi = cslope_bx.bigEnd();
+
+    const IntVect e[3] = { IntVect(1,0,0), IntVect(0,1,0), IntVect(0,0,1) };
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        for (int dir = 0; dir < 3; ++dir)
+        {
+            const int sn = dir*ncomp + n;
+            const int di = e[dir][0], dj = e[dir][1], dk = e[dir][2];
+
+            for (int k = slo[2]; k <= shi[2]; ++k) {
+            for (int j = slo[1]; j <= shi[1]; ++j) {
+            for (int i = slo[0]; i <= shi[0]; ++i) {
+                const Real cm = c(i-di,j-dj,k-dk,n);
+                const Real c0 = c(i,j,k,n);
+                const Real cp = c(i+di,j+dj,k+dk,n);
+                const Real cen = 0.5*(cp-cm);
+                uc(i,j,k,sn) = cen;
+                lc(i,j,k,sn) = mc_slope(cen, 2.0*(cp-c0), 2.0*(c0-cm));
+            }}}
+
+            const bool ok = cslope_bx.length(dir) >= 2;
+
+            for (int side = 0; side < 2; ++side)
+            {
+                const int bc = (side == 0) ? bcr[n].lo(dir) : bcr[n].hi(dir);
+                if (bc != EXT_DIR && bc != HOEXTRAP) continue;
+
+                const int sgn = (side == 0) ? 1 : -1;
+                Box face(cslope_bx);
+                if (side == 0) {
+                    face.setBig(dir, slo[dir]);
+                } else {
+                    face.setSmall(dir, shi[dir]);
+                }
+                const IntVect& flo = face.smallEnd();
+                const IntVect& fhi = face.bigEnd();
+
+                for (int k = flo[2]; k <= fhi[2]; ++k) {
+                for (int j = flo[1]; j <= fhi[1]; ++j) {
+                for (int i = flo[0]; i <= fhi[0]; ++i) {
+                    // Neighbors away from (out) and into (in) the boundary.
+                    const int oi = -sgn*di, oj = -sgn*dj, ok_ = -sgn*dk;
+                    const Real cout = c(i+oi,j+oj,k+ok_,n);
+                    const Real c0   = c(i,j,k,n);
+                    const Real cin  = c(i-oi,j-oj,k-ok_,n);
+                    Real cen;
+                    if (ok) {
+                        const Real cin2 = c(i-2*oi,j-2*oj,k-2*ok_,n);
+                        cen = sgn*(-16.0/15.0*cout + 0.5*c0
+                                   + 0.66666666666666667*cin - 0.1*cin2);
+                    } else {
+                        cen = sgn*0.25*(cin + 5.0*c0 - 6.0*cout);
+                    }
+                    uc(i,j,k,sn) = cen;
+                    const Real cp = c(i+di,j+dj,k+dk,n);
+                    const Real cm = c(i-di,j-dj,k-dk,n);
+                    lc(i,j,k,sn) = mc_slope(cen, 2.0*(cp-c0), 2.0*(c0-cm));
+                }}}
+            }
+        }
+    }
+
+    alfab.setVal(1.0);
+
+    if (lin_limit)
+    {
+        //
+        // One limiting factor per direction for all components.
+        //
+        for (int dir = 0; dir < 3; ++dir)
+        {
+            for (int k = slo[2]; k <= shi[2]; ++k) {
+            for (int j = slo[1]; j <= shi[1]; ++j) {
+            for (int i = slo[0]; i <= shi[0]; ++i) {
+                Real factor = 1.0;
+                for (int n = 0; n < ncomp; ++n) {
+                    const int sn = dir*ncomp + n;
+                    // As in the Fortran, a zero unlimited slope in any
+                    // component gives a zero factor.
+                    const Real denom = (uc(i,j,k,sn) != 0.0) ? uc(i,j,k,sn) : 1.0;
+                    const Real fn = lc(i,j,k,sn)/denom;
+                    factor = std::min(factor,fn);
+                }
+                for (int n = 0; n < ncomp; ++n) {
+                    const int sn = dir*ncomp + n;
+                    lc(i,j,k,sn) = factor*uc(i,j,k,sn);
+                }
+            }}}
+        }
+    }
+    else
+    {
+        //
+        // Limit the slopes so as not to introduce new extrema.
+        //
+        const Real eps = static_cast<float>(1.e-10);
+
+        for (int n = 0; n < ncomp; ++n)
+        {
+            for (int kc = slo[2]; kc <= shi[2]; ++kc) {
+            for (int jc = slo[1]; jc <= shi[1]; ++jc) {
+            for (int ic = slo[0]; ic <= shi[0]; ++ic) {
+                const Real c0 = c(ic,jc,kc,n);
+                Real cmax = c0, cmin = c0;
+                for (int koff = -1; koff <= 1; ++koff) {
+                for (int joff = -1; joff <= 1; ++joff) {
+                for (int ioff = -1; ioff <= 1; ++ioff) {
+                    const Real cv = c(ic+ioff,jc+joff,kc+koff,n);
+                    cmax = std::max(cmax,cv);
+                    cmin = std::min(cmin,cv);
+                }}}
+
+                const Real sx = lc(ic,jc,kc,n);
+                const Real sy = lc(ic,jc,kc,ncomp+n);
+                const Real sz = lc(ic,jc,kc,2*ncomp+n);
+                Real alpha = 1.0;
+                for (int koff = 0; koff < R; ++koff) {
+                for (int joff = 0; joff < R; ++joff) {
+                for (int ioff = 0; ioff < R; ++ioff) {
+                    const Real orig = voff[ioff]*sx + voff[joff]*sy + voff[koff]*sz;
+                    const Real dummy = c0 + orig;
+                    if (dummy > cmax && std::abs(orig) > eps*std::abs(c0)) {
+                        alpha = std::min(alpha, (cmax-c0)/orig);
+                    }
+                    if (dummy < cmin && std::abs(orig) > eps*std::abs(c0)) {
+                        alpha = std::min(alpha, (cmin-c0)/orig);
+                    }
+                }}}
+                al(ic,jc,kc,n) = alpha;
+            }}}
+        }
+    }
+
+    //
+    // Fill the fine cells, one coarse cell at a time.
+    //
+    const IntVect& flo = fine_region.smallEnd();
+    const IntVect& fhi = fine_region.bigEnd();
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        for (int kc = slo[2]; kc <= shi[2]; ++kc) {
+        for (int jc = slo[1]; jc <= shi[1]; ++jc) {
+        for (int ic = slo[0]; ic <= shi[0]; ++ic) {
+            const Real c0 = c(ic,jc,kc,n);
+            const Real a  = al(ic,jc,kc,n);
+            const Real sx = lc(ic,jc,kc,n);
+            const Real sy = lc(ic,jc,kc,ncomp+n);
+            const Real sz = lc(ic,jc,kc,2*ncomp+n);
+
+            const int klo = std::max(flo[2],kc*R) - kc*R;
+            const int khi = std::min(fhi[2],kc*R+R-1) - kc*R;
+            const int jlo = std::max(flo[1],jc*R) - jc*R;
+            const int jhi = std::min(fhi[1],jc*R+R-1) - jc*R;
+            const int ilo = std::max(flo[0],ic*R) - ic*R;
+            const int ihi = std::min(fhi[0],ic*R+R-1) - ic*R;
+
+            for (int koff = klo; koff <= khi; ++koff) {
+            for (int joff = jlo; joff <= jhi; ++joff) {
+                Real* fp = f.ptr(ic*R,jc*R+joff,kc*R+koff,n);
+                const Real vy = voff[joff]*sy;
+                const Real vz = voff[koff]*sz;
+                if (ilo == 0 && ihi == R-1) {
+                    for (int ioff = 0; ioff < R; ++ioff) {
+                        fp[ioff] = c0 + a*(voff[ioff]*sx + vy + vz);
+                    }
+                } else {
+                    for (int ioff = ilo; ioff <= ihi; ++ioff) {
+                        fp[ioff] = c0 + a*(voff[ioff]*sx + vy + vz);
+                    }
+                }
+            }}
+        }}}
+    }
+}
+
+}
+#endif
+
 InterpolaterBoxCoarsener
 Interpolater::BoxCoarsener (const IntVect& ratio)
 { 
@@ -102,6 +450,19 @@ NodeBilinear::interp (const FArrayBox&  crse,
                       int               actual_state)
 {
     BL_PROFILE("NodeBilinear::interp()");
+
+#if (AMREX_SPACEDIM == 3)
+    if (specialize_ratio)
+    {
+        if (ratio == 2) {
+            nbinterp<2>(crse,crse_comp,fine,fine_comp,ncomp);
+            return;
+        } else if (ratio == 4) {
+            nbinterp<4>(crse,crse_comp,fine,fine_comp,ncomp);
+            return;
+        }
+    }
+#endif
     //
     // Set up to call FORTRAN.
     //
@@ -284,6 +645,21 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     //
     Box cslope_bx(crse_bx);
     cslope_bx.grow(-1);
+
+#if (AMREX_SPACEDIM == 3)
+    if (specialize_ratio && crse_geom.IsCartesian())
+    {
+        if (ratio == 2) {
+            linccinterp<2>(crse,crse_comp,fine,fine_comp,ncomp,target_fine_region,
+                           cslope_bx,bcr,do_linear_limiting);
+            return;
+        } else if (ratio == 4) {
+            linccinterp<4>(crse,crse_comp,fine,fine_comp,ncomp,target_fine_region,
+                           cslope_bx,bcr,do_linear_limiting);
+            return;
+        }
+    }
+#endif
     //
     // Make a refinement of cslope_bx
     //
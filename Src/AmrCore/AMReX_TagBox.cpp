@@ -2,6 +2,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <map>
+#include <utility>
 
 #include <AMReX_TagBox.H>
 #include <AMReX_Geometry.H>
@@ -11,6 +13,141 @@
 
 namespace amrex {
 
+namespace {
+
+typedef TagBox::TagRun  TagRun;
+typedef TagBox::TagType TagType;
+
+bool
+sameRow (const TagRun& a, const TagRun& b)
+{
+    for (int d = 1; d < AMREX_SPACEDIM; ++d) {
+        if (a.lo[d] != b.lo[d]) return false;
+    }
+    return true;
+}
+
+//
+// Runs are ordered like the cells of a FAB: by row, the last direction
+// varying slowest, and within a row by their first cell.
+//
+bool
+runLess (const TagRun& a, const TagRun& b)
+{
+    for (int d = AMREX_SPACEDIM-1; d >= 0; --d) {
+        if (a.lo[d] != b.lo[d]) return a.lo[d] < b.lo[d];
+    }
+    return false;
+}
+
+//
+// Clip run r to bx.  Returns false if they do not intersect.
+//
+bool
+clipRun (TagRun& r, const Box& bx)
+{
+    for (int d = 1; d < AMREX_SPACEDIM; ++d) {
+        if (r.lo[d] < bx.smallEnd(d) || r.lo[d] > bx.bigEnd(d)) return false;
+    }
+    const int lo = std::max(r.lo[0], bx.smallEnd(0));
+    const int hi = std::min(r.lo[0]+r.len-1, bx.bigEnd(0));
+    if (hi < lo) return false;
+    r.lo[0] = lo;
+    r.len   = hi-lo+1;
+    return true;
+}
+
+//
+// Sort the runs and make them disjoint.  Where runs overlap the larger
+// tag wins, as it does in the dense coarsen and buffer.
+//
+void
+normalizeRuns (Vector<TagRun>& runs)
+{
+    std::sort(runs.begin(), runs.end(), runLess);
+
+    Vector<TagRun> out;
+    out.reserve(runs.size());
+
+    std::vector<TagType> vals;
+    std::vector<std::pair<int,int> > upper, cur;
+
+    const int N = runs.size();
+
+    for (int b = 0, e = 0; b < N; b = e)
+    {
+        vals.clear();
+        for (e = b; e < N && sameRow(runs[b],runs[e]); ++e)
+        {
+            if (runs[e].val != TagBox::CLEAR &&
+                std::find(vals.begin(),vals.end(),runs[e].val) == vals.end())
+            {
+                vals.push_back(runs[e].val);
+            }
+        }
+        std::sort(vals.rbegin(), vals.rend());
+
+        const int nout = out.size();
+
+        upper.clear();
+        for (TagType v : vals)
+        {
+            //
+            // The union of the runs in this row with a tag of at least v ...
+            //
+            cur.clear();
+            for (int n = b; n < e; ++n)
+            {
+                if (runs[n].val >= v)
+                {
+                    const int lo = runs[n].lo[0];
+                    const int hi = lo + runs[n].len - 1;
+                    if (!cur.empty() && lo <= cur.back().second+1) {
+                        cur.back().second = std::max(cur.back().second, hi);
+                    } else {
+                        cur.push_back(std::make_pair(lo,hi));
+                    }
+                }
+            }
+            //
+            // ... less the part already covered by a larger tag gets v.
+            //
+            auto it = upper.cbegin();
+            for (const auto& iv : cur)
+            {
+                int lo = iv.first;
+                while (lo <= iv.second)
+                {
+                    while (it != upper.cend() && it->second < lo) ++it;
+                    int hi = iv.second;
+                    if (it != upper.cend() && it->first <= hi) {
+                        hi = it->first - 1;
+                    }
+                    if (hi >= lo)
+                    {
+                        TagRun r = runs[b];
+                        r.lo[0] = lo;
+                        r.len   = hi-lo+1;
+                        r.val   = v;
+                        out.push_back(r);
+                    }
+                    if (it == upper.cend() || it->first > iv.second) break;
+                    lo = it->second + 1;
+                }
+            }
+            upper.swap(cur);
+        }
+
+        if (vals.size() > 1) {
+            std::sort(out.begin()+nout, out.end(), runLess);
+        }
+    }
+
+    runs.swap(out);
+}
+
+}
+
 TagBox::TagBox () {}
 
 TagBox::TagBox (const Box& bx,
@@ -28,6 +165,21 @@ TagBox::coarsen (const IntVect& ratio, bool owner)
 {
     BL_ASSERT(nComp() == 1);
 
+    if (m_sparse)
+    {
+        for (auto& r : m_runs)
+        {
+            IntVect hi = r.lo;
+            hi[0] += r.len-1;
+            r.lo = amrex::coarsen(r.lo,ratio);
+            hi   = amrex::coarsen(hi,ratio);
+            r.len = hi[0]-r.lo[0]+1;
+        }
+        normalizeRuns(m_runs);
+        setSparseDomain(amrex::coarsen(domain,ratio));
+        return;
+    }
+
     TagType*   fdat     = dataPtr();
     IntVect    lov      = domain.smallEnd();
     IntVect    hiv      = domain.bigEnd();
@@ -111,6 +263,47 @@ TagBox::buffer (int nbuff,
     //
     Box inside(domain);
     inside.grow(-nwid);
+
+    if (m_sparse)
+    {
+        //
+        // The buffer is the union of the SET runs grown by nbuff in every
+        // direction.  Grow them along the rows first and then one
+        // direction at a time, merging in between, so that overlapping
+        // neighbors are only generated once.
+        //
+        Vector<TagRun> grown;
+        for (TagRun r : m_runs)
+        {
+            if (r.val == TagBox::SET && clipRun(r,inside))
+            {
+                r.lo[0] -= nbuff;
+                r.len   += 2*nbuff;
+                r.val    = TagBox::BUF;
+                grown.push_back(r);
+            }
+        }
+        for (int d = 1; d < AMREX_SPACEDIM && nbuff > 0; ++d)
+        {
+            Vector<TagRun> next;
+            next.reserve((2*nbuff+1)*grown.size());
+            for (const auto& r : grown)
+            {
+                for (int n = -nbuff; n <= nbuff; ++n)
+                {
+                    TagRun b = r;
+                    b.lo[d] += n;
+                    next.push_back(b);
+                }
+            }
+            normalizeRuns(next);
+            grown.swap(next);
+        }
+        m_runs.insert(m_runs.end(), grown.begin(), grown.end());
+        normalizeRuns(m_runs);
+        return;
+    }
+
     const int* inlo = inside.loVect();
     const int* inhi = inside.hiVect();
     int klo = 0, khi = 0, jlo = 0, jhi = 0, ilo, ihi;
@@ -158,6 +351,12 @@ TagBox::buffer (int nbuff,
 void 
 TagBox::merge (const TagBox& src)
 {
+    if (m_sparse)
+    {
+        BL_ASSERT(src.m_sparse);
+        merge(src.m_runs);
+        return;
+    }
     //
     // Compute intersections.
     //
@@ -202,9 +401,163 @@ TagBox::merge (const TagBox& src)
 #undef OFF
 }
 
+void
+TagBox::merge (const Vector<TagRun>& runs)
+{
+    BL_ASSERT(m_sparse);
+
+    for (TagRun r : runs)
+    {
+        if (r.val != TagBox::CLEAR && clipRun(r,domain))
+        {
+            r.val = TagBox::SET;
+            m_runs.push_back(r);
+        }
+    }
+    normalizeRuns(m_runs);
+}
+
+void
+TagBox::setTagVal (TagVal     val,
+                   const Box& bx)
+{
+    if (!m_sparse)
+    {
+        setVal(val,bx,0);
+        return;
+    }
+
+    const Box& b = bx & domain;
+
+    if (!b.ok()) return;
+
+    Vector<TagRun> runs;
+    runs.reserve(m_runs.size());
+    //
+    // Cut b out of the runs ...
+    //
+    for (const auto& r : m_runs)
+    {
+        TagRun c = r;
+        if (!clipRun(c,b))
+        {
+            runs.push_back(r);
+            continue;
+        }
+        if (c.lo[0] > r.lo[0])
+        {
+            TagRun left = r;
+            left.len = c.lo[0] - r.lo[0];
+            runs.push_back(left);
+        }
+        const int cend = c.lo[0] + c.len;
+        const int rend = r.lo[0] + r.len;
+        if (rend > cend)
+        {
+            TagRun right = r;
+            right.lo[0] = cend;
+            right.len   = rend - cend;
+            runs.push_back(right);
+        }
+    }
+    //
+    // ... and fill it with val.
+    //
+    if (val != TagBox::CLEAR)
+    {
+        Box rows(b);
+        rows.setBig(0,b.smallEnd(0));
+        for (IntVect p = rows.smallEnd(), End = rows.bigEnd(); p <= End; rows.next(p))
+        {
+            TagRun r;
+            r.lo  = p;
+            r.len = b.length(0);
+            r.val = val;
+            runs.push_back(r);
+        }
+        normalizeRuns(runs);
+    }
+
+    m_runs.swap(runs);
+}
+
+void
+TagBox::makeSparse ()
+{
+    if (m_sparse) return;
+
+    BL_ASSERT(nComp() == 1);
+
+    m_runs.clear();
+
+    Box rows(domain);
+    rows.setBig(0,domain.smallEnd(0));
+    const int nx = domain.length(0);
+
+    for (IntVect p = rows.smallEnd(), End = rows.bigEnd(); p <= End; rows.next(p))
+    {
+        const TagType* d = &(*this)(p);
+        for (int i = 0; i < nx; )
+        {
+            if (d[i] == TagBox::CLEAR)
+            {
+                ++i;
+                continue;
+            }
+            int j = i+1;
+            while (j < nx && d[j] == d[i]) ++j;
+            TagRun r;
+            r.lo     = p;
+            r.lo[0] += i;
+            r.len    = j-i;
+            r.val    = d[i];
+            m_runs.push_back(r);
+            i = j;
+        }
+    }
+
+    clear();
+
+    m_sparse = true;
+}
+
+void
+TagBox::makeDense ()
+{
+    if (!m_sparse) return;
+
+    m_sparse = false;
+
+    resize(domain,1);
+    setVal(TagBox::CLEAR);
+
+    for (const auto& r : m_runs)
+    {
+        TagType* d = &(*this)(r.lo);
+        std::fill(d, d+r.len, r.val);
+    }
+
+    Vector<TagRun>().swap(m_runs);
+}
+
+void
+TagBox::setSparseDomain (const Box& bx)
+{
+    domain = bx;
+    dlen   = bx.size();
+    numpts = bx.numPts();
+}
+
 long
 TagBox::numTags () const
 {
+    if (m_sparse)
+    {
+        long nt = 0L;
+        for (const auto& r : m_runs) nt += r.len;
+        return nt;
+    }
+
     long nt = 0L;
     long len = domain.numPts();
     const TagType* d = dataPtr();
@@ -219,6 +572,15 @@ TagBox::numTags () const
 long
 TagBox::numTags (const Box& b) const
 {
+    if (m_sparse)
+    {
+        long nt = 0L;
+        for (TagRun r : m_runs) {
+            if (clipRun(r,b)) nt += r.len;
+        }
+        return nt;
+    }
+
    TagBox tempTagBox(b,1);
    tempTagBox.copy(*this);
    return tempTagBox.numTags();
@@ -232,6 +594,20 @@ TagBox::collate (Vector<IntVect>& ar, int start) const
     // Starting at given offset of array ar, enter location (IntVect) of
     // each tagged cell in tagbox.
     //
+    if (m_sparse)
+    {
+        long count = 0;
+        for (const auto& r : m_runs)
+        {
+            IntVect p = r.lo;
+            for (int i = 0; i < r.len; ++i, ++p[0]) {
+                ar[start++] = p;
+            }
+            count += r.len;
+        }
+        return count;
+    }
+
     long count       = 0;
     IntVect d_length = domain.size();
     const int* len   = d_length.getVect();
@@ -459,6 +835,12 @@ TagBoxArray::mapPeriodic (const Geometry& geom)
     // So we can assume that n_grow is 0.
     BL_ASSERT(n_grow == 0);
 
+    if (m_sparse)
+    {
+        mapPeriodicSparse(geom);
+        return;
+    }
+
     TagBoxArray tmp(boxArray(),DistributionMap()); // note that tmp is filled w/ CLEAR.
 
     tmp.copy(*this, geom.periodicity(), FabArrayBase::ADD);
@@ -472,6 +854,122 @@ TagBoxArray::mapPeriodic (const Geometry& geom)
     }
 }
 
+void
+TagBoxArray::mapPeriodicSparse (const Geometry& geom)
+{
+    //
+    // As in the dense version, every cell gets tagged if it, or one of
+    // its periodic images, is tagged in any of the TagBoxes, which may
+    // overlap.  Only the runs that land in another TagBox are sent.
+    //
+    const BoxArray&            ba      = boxArray();
+    const DistributionMapping& dm      = DistributionMap();
+    const std::vector<IntVect> pshifts = geom.periodicity().shiftIntVect();
+    const int                  NProcs  = ParallelDescriptor::NProcs();
+    const int                  MyProc  = ParallelDescriptor::MyProc();
+    //
+    // Each run is sent as the index of the destination box, its first
+    // cell and its length.
+    //
+    const int nints = AMREX_SPACEDIM+2;
+
+    Vector<Vector<int> > sendbuf(NProcs);
+
+    std::vector< std::pair<int,Box> > isects;
+
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        const int i = mfi.index();
+
+        for (const auto& r : get(mfi).tagRuns())
+        {
+            IntVect hi = r.lo;
+            hi[0] += r.len-1;
+
+            for (const auto& iv : pshifts)
+            {
+                Box rbx(r.lo,hi);
+                rbx.shift(iv);
+
+                ba.intersections(rbx,isects);
+
+                for (const auto& is : isects)
+                {
+                    if (is.first == i && iv == IntVect::TheZeroVector()) continue;
+
+                    Vector<int>& buf = sendbuf[dm[is.first]];
+                    buf.push_back(is.first);
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                        buf.push_back(is.second.smallEnd(d));
+                    }
+                    buf.push_back(is.second.length(0));
+                }
+            }
+        }
+    }
+
+    Vector<int> recvbuf;
+
+#if BL_USE_MPI
+    {
+        Vector<int> sendcnt(NProcs,0), recvcnt(NProcs,0);
+        Vector<int> sdispl(NProcs,0), rdispl(NProcs,0);
+
+        for (int i = 0; i < NProcs; ++i) {
+            if (i != MyProc) sendcnt[i] = sendbuf[i].size();
+        }
+
+        BL_MPI_REQUIRE( MPI_Alltoall(sendcnt.dataPtr(), 1,
+                                     ParallelDescriptor::Mpi_typemap<int>::type(),
+                                     recvcnt.dataPtr(), 1,
+                                     ParallelDescriptor::Mpi_typemap<int>::type(),
+                                     ParallelDescriptor::Communicator()) );
+
+        for (int i = 1; i < NProcs; ++i)
+        {
+            sdispl[i] = sdispl[i-1] + sendcnt[i-1];
+            rdispl[i] = rdispl[i-1] + recvcnt[i-1];
+        }
+
+        Vector<int> sendflat(sdispl[NProcs-1] + sendcnt[NProcs-1]);
+        for (int i = 0; i < NProcs; ++i) {
+            if (sendcnt[i] > 0) {
+                std::copy(sendbuf[i].begin(), sendbuf[i].end(), sendflat.begin()+sdispl[i]);
+            }
+            if (i != MyProc) Vector<int>().swap(sendbuf[i]);
+        }
+
+        recvbuf.resize(rdispl[NProcs-1] + recvcnt[NProcs-1]);
+
+        BL_MPI_REQUIRE( MPI_Alltoallv(sendflat.dataPtr(), sendcnt.dataPtr(), sdispl.dataPtr(),
+                                      ParallelDescriptor::Mpi_typemap<int>::type(),
+                                      recvbuf.dataPtr(), recvcnt.dataPtr(), rdispl.dataPtr(),
+                                      ParallelDescriptor::Mpi_typemap<int>::type(),
+                                      ParallelDescriptor::Communicator()) );
+    }
+#endif
+
+    recvbuf.insert(recvbuf.end(), sendbuf[MyProc].begin(), sendbuf[MyProc].end());
+
+    std::map<int,Vector<TagBox::TagRun> > incoming;
+
+    for (int n = 0, N = recvbuf.size(); n < N; n += nints)
+    {
+        TagBox::TagRun r;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            r.lo[d] = recvbuf[n+1+d];
+        }
+        r.len = recvbuf[n+1+AMREX_SPACEDIM];
+        r.val = TagBox::SET;
+        incoming[recvbuf[n]].push_back(r);
+    }
+
+    for (const auto& kv : incoming)
+    {
+        (*this)[kv.first].merge(kv.second);
+    }
+}
+
 long
 TagBoxArray::numTags () const 
 {
@@ -621,7 +1119,7 @@ TagBoxArray::setVal (const BoxArray& ba,
 
         for (int i = 0, N = isects.size(); i < N; i++)
         {
-            tags.setVal(val,isects[i].second,0);
+            tags.setTagVal(val,isects[i].second);
         }
     }
 }
@@ -647,6 +1145,38 @@ TagBoxArray::coarsen (const IntVect & ratio)
     n_grow = 0;
 }
 
+void
+TagBoxArray::makeSparse ()
+{
+    if (m_sparse || SharedMemory()) return;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        get(mfi).makeSparse();
+    }
+
+    m_sparse = true;
+}
+
+void
+TagBoxArray::makeDense ()
+{
+    if (!m_sparse) return;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        get(mfi).makeDense();
+    }
+
+    m_sparse = false;
+}
+
 void
 TagBoxArray::AddProcsToComp (int ioProcNumSCS, int ioProcNumAll,
                              int scsMyId, MPI_Comm scsComm)
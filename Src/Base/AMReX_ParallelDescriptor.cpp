@@ -2835,6 +2835,71 @@ ParallelDescriptor::ReadAndBcastFile (const std::string& filename,
     charBuf[fileLength] = '\0';
 }
 
+void
+ParallelDescriptor::ReadAndBcastFiles (const Vector<std::string>& filenames,
+                                       Vector<Vector<char> >&     charBufs,
+                                       bool                       bExitOnError)
+{
+    enum { IO_Buffer_Size = 262144 * 8 };
+
+#ifdef BL_SETBUF_SIGNED_CHAR
+    typedef signed char Setbuf_Char_Type;
+#else
+    typedef char Setbuf_Char_Type;
+#endif
+
+    const int nFiles = filenames.size();
+    const int nProcs = ParallelDescriptor::NProcs();
+    const int myProc = ParallelDescriptor::MyProc();
+
+    charBufs.resize(nFiles);
+
+    if (nFiles == 0) return;
+
+    //
+    // -2 on the ranks that do not read the file, -1 if it cannot be read.
+    //
+    Vector<long> fileLength(nFiles, -2);
+
+    Vector<Setbuf_Char_Type> io_buffer;
+
+    for (int i = myProc; i < nFiles; i += nProcs)
+    {
+        if (io_buffer.empty()) io_buffer.resize(IO_Buffer_Size);
+
+        std::ifstream iss;
+        iss.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+        iss.open(filenames[i].c_str(), std::ios::in);
+        if ( ! iss.good()) {
+            if (bExitOnError) {
+                amrex::FileOpenFailed(filenames[i]);
+            }
+            fileLength[i] = -1;
+            continue;
+        }
+        iss.seekg(0, std::ios::end);
+        fileLength[i] = iss.tellg();
+        iss.seekg(0, std::ios::beg);
+        charBufs[i].resize(fileLength[i]);
+        iss.read(charBufs[i].dataPtr(), fileLength[i]);
+    }
+
+    ParallelDescriptor::ReduceLongMax(fileLength.dataPtr(), nFiles);
+
+    for (int i = 0; i < nFiles; ++i)
+    {
+        if (fileLength[i] < 0) {
+            charBufs[i].clear();
+            continue;
+        }
+        long fileLengthPadded = fileLength[i] + 1;
+        fileLengthPadded += fileLengthPadded % 8;
+        charBufs[i].resize(fileLengthPadded);
+        ParallelDescriptor::Bcast(charBufs[i].dataPtr(), fileLengthPadded, i % nProcs);
+        charBufs[i][fileLength[i]] = '\0';
+    }
+}
+
 
 #ifndef BL_AMRPROF
 void
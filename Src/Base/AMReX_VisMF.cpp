@@ -31,6 +31,7 @@ bool VisMF::useSingleWrite(false);
 bool VisMF::checkFilePositions(false);
 bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
+bool VisMF::useDirectReads(false);
 bool VisMF::useDynamicSetSelection(true);
 bool VisMF::allowSparseWrites(true);
 
@@ -81,6 +82,7 @@ VisMF::Initialize ()
     pp.query("checkfilepositions", checkFilePositions);
     pp.query("usepersistentifstreams", usePersistentIFStreams);
     pp.query("usesynchronousreads", useSynchronousReads);
+    pp.query("usedirectreads", useDirectReads);
     pp.query("usedynamicsetselection", useDynamicSetSelection);
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
@@ -1427,7 +1429,57 @@ VisMF::Read (FabArray<FArrayBox> &mf,
   int nProcs(ParallelDescriptor::NProcs());
   bool noFabHeader(NoFabHeader(hdr));
 
-  if(noFabHeader && useSynchronousReads) {
+  if(useDirectReads) {
+
+    // ---- Each rank reads the fabs it owns in mf, whatever its
+    // ---- DistributionMapping, straight from the files.  There is no
+    // ---- coordinator and no file ordered copy of mf.  Each file is
+    // ---- opened once per rank and read in offset order.
+    bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
+
+    std::map<std::string, Vector<std::pair<long,int> > > myReads;   // ---- [filename, [offset, index]]
+
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+      int idx(mfi.index());
+      myReads[hdr.m_fod[idx].m_name].push_back(std::make_pair(hdr.m_fod[idx].m_head, idx));
+    }
+
+    VisMF::IO_Buffer ioBuffer(setBuf ? ioBufferSize : 0);
+
+    for(auto &mr : myReads) {
+      std::string fullFileName(VisMF::DirName(mf_name) + mr.first);
+      std::ifstream ifs;
+      if(setBuf) {
+        ifs.rdbuf()->pubsetbuf(ioBuffer.dataPtr(), ioBuffer.size());
+      }
+      ifs.open(fullFileName.c_str(), std::ios::in | std::ios::binary);
+      if( ! ifs.good()) {
+        amrex::FileOpenFailed(fullFileName);
+      }
+
+      Vector<std::pair<long,int> > &reads = mr.second;
+      std::sort(reads.begin(), reads.end());
+
+      for(const auto &rd : reads) {
+        if(static_cast<long>(ifs.tellg()) != rd.first) {
+          ifs.seekg(rd.first, std::ios::beg);
+        }
+        FArrayBox &fab = mf[rd.second];
+        if(noFabHeader) {
+          if(doConvert) {
+            long readDataItems(fab.box().numPts() * fab.nComp());
+            RealDescriptor::convertToNativeFormat(fab.dataPtr(), readDataItems,
+                                                  ifs, hdr.m_writtenRD);
+          } else {
+            ifs.read((char *) fab.dataPtr(), fab.nBytes());
+          }
+        } else {
+          fab.readFrom(ifs);
+        }
+      }
+    }
+
+  } else if(noFabHeader && useSynchronousReads) {
 
     // ---- This code is only for reading in file order
     bool doConvert(hdr.m_writtenRD != FPC::NativeRealDescriptor());
@@ -1631,7 +1683,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
       faCopyTime = ParallelDescriptor::second() - faCopyTime;
     }
 
-  } else {    // ---- (noFabHeader && useSynchronousReads) == false
+  } else {    // ---- neither direct nor synchronous reads
 
     int nReqs(0), ioProcNum(coordinatorProc);
     int nBoxes(hdr.m_ba.size());
@@ -11,9 +11,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<BoxArray>& a_grids,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  const int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
 }
 
 void
@@ -21,14 +22,19 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<BoxArray>& a_grids,
                          const Vector<DistributionMapping>& a_dmap,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         const int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define()");
 
+    m_ncomp = a_ncomp;
+
     MLCellLinOp::define(a_geom, a_grids, a_dmap, a_info, a_factory);
 
     m_a_coeffs.resize(m_num_amr_levels);
     m_b_coeffs.resize(m_num_amr_levels);
+    m_a_needs_metric.assign(m_num_amr_levels, true);
+    m_b_needs_metric.assign(m_num_amr_levels, true);
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_a_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
@@ -57,6 +63,7 @@ MLABecLaplacian::setScalars (Real a, Real b)
 {
     m_a_scalar = a;
     m_b_scalar = b;
+    m_needs_update = true;
     if (a == 0.0)
     {
         for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
@@ -70,6 +77,8 @@ void
 MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
+    m_a_needs_metric[amrlev] = true;
+    m_needs_update = true;
 }
 
 void
@@ -79,6 +88,30 @@ MLABecLaplacian::setBCoeffs (int amrlev,
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, 0, 1, 0);
     }
+    m_b_needs_metric[amrlev] = true;
+    m_needs_update = true;
+}
+
+void
+MLABecLaplacian::setStencilCache (bool flag)
+{
+    m_use_stencil_cache = flag;
+    if (!flag) {
+        m_stencil_precision = StencilPrecision::full;
+        m_stencil.clear();
+        m_stencil_sp.clear();
+    }
+    m_needs_update = true;
+}
+
+void
+MLABecLaplacian::setStencilPrecision (StencilPrecision p)
+{
+    m_stencil_precision = p;
+    if (p != StencilPrecision::full) {
+        m_use_stencil_cache = true;
+    }
+    m_needs_update = true;
 }
 
 void
@@ -163,10 +196,16 @@ MLABecLaplacian::applyMetricTermsCoeffs ()
     for (int alev = 0; alev < m_num_amr_levels; ++alev)
     {
         const int mglev = 0;
-        applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
-        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
-        {
-            applyMetricTerm(alev, mglev, m_b_coeffs[alev][mglev][idim]);
+        if (m_a_needs_metric[alev]) {
+            applyMetricTerm(alev, mglev, m_a_coeffs[alev][mglev]);
+            m_a_needs_metric[alev] = false;
+        }
+        if (m_b_needs_metric[alev]) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                applyMetricTerm(alev, mglev, m_b_coeffs[alev][mglev][idim]);
+            }
+            m_b_needs_metric[alev] = false;
         }
     }
 #endif
@@ -208,6 +247,99 @@ MLABecLaplacian::prepareForSolve ()
             }
         }
     }
+
+    m_stencil.clear();
+    m_stencil_sp.clear();
+#if (AMREX_SPACEDIM == 3)
+    if (m_use_stencil_cache) {
+        buildStencilCache();
+    }
+#endif
+}
+
+void
+MLABecLaplacian::buildStencilCache ()
+{
+#if (AMREX_SPACEDIM == 3)
+    BL_PROFILE("MLABecLaplacian::buildStencilCache()");
+
+    const bool use_sp = m_stencil_precision != StencilPrecision::full;
+
+    m_stencil.resize(m_num_amr_levels);
+    if (use_sp) m_stencil_sp.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_stencil[amrlev].resize(m_num_mg_levels[amrlev]);
+        if (use_sp) m_stencil_sp[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            MultiFab& stencil = m_stencil[amrlev][mglev];
+            stencil.define(m_grids[amrlev][mglev], m_dmap[amrlev][mglev], nstencil, 0);
+
+            const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+            const auto& bcoef = m_b_coeffs[amrlev][mglev];
+            const auto& undrrelxr = m_undrrelxr[amrlev][mglev];
+            const auto& maskvals  = m_maskvals [amrlev][mglev];
+            const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
+            const Orientation xlo(0,Orientation::low), xhi(0,Orientation::high);
+            const Orientation ylo(1,Orientation::low), yhi(1,Orientation::high);
+            const Orientation zlo(2,Orientation::low), zhi(2,Orientation::high);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            for (MFIter mfi(stencil, true); mfi.isValid(); ++mfi)
+            {
+                const Box& bx  = mfi.tilebox();
+                const Box& vbx = mfi.validbox();
+
+                amrex_mlabeclap_stencil(BL_TO_FORTRAN_BOX(bx),
+                                        BL_TO_FORTRAN_ANYD(stencil[mfi]),
+                                        BL_TO_FORTRAN_ANYD(acoef[mfi]),
+                                        BL_TO_FORTRAN_ANYD(bcoef[0][mfi]),
+                                        BL_TO_FORTRAN_ANYD(bcoef[1][mfi]),
+                                        BL_TO_FORTRAN_ANYD(bcoef[2][mfi]),
+                                        BL_TO_FORTRAN_ANYD(undrrelxr[xlo][mfi]),
+                                        BL_TO_FORTRAN_ANYD(maskvals[xlo][mfi]),
+                                        BL_TO_FORTRAN_ANYD(undrrelxr[ylo][mfi]),
+                                        BL_TO_FORTRAN_ANYD(maskvals[ylo][mfi]),
+                                        BL_TO_FORTRAN_ANYD(undrrelxr[zlo][mfi]),
+                                        BL_TO_FORTRAN_ANYD(maskvals[zlo][mfi]),
+                                        BL_TO_FORTRAN_ANYD(undrrelxr[xhi][mfi]),
+                                        BL_TO_FORTRAN_ANYD(maskvals[xhi][mfi]),
+                                        BL_TO_FORTRAN_ANYD(undrrelxr[yhi][mfi]),
+                                        BL_TO_FORTRAN_ANYD(maskvals[yhi][mfi]),
+                                        BL_TO_FORTRAN_ANYD(undrrelxr[zhi][mfi]),
+                                        BL_TO_FORTRAN_ANYD(maskvals[zhi][mfi]),
+                                        BL_TO_FORTRAN_BOX(vbx),
+                                        dxinv, m_a_scalar, m_b_scalar);
+            }
+
+            if (use_sp && (mglev > 0 || m_stencil_precision == StencilPrecision::single_cycle))
+            {
+                auto& stencil_sp = m_stencil_sp[amrlev][mglev];
+                stencil_sp.define(stencil.boxArray(), stencil.DistributionMap(), nstencil, 0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+                for (MFIter mfi(stencil_sp); mfi.isValid(); ++mfi)
+                {
+                    const Real* src = stencil[mfi].dataPtr();
+                    float* dst = stencil_sp[mfi].dataPtr();
+                    const long n = stencil_sp[mfi].box().numPts() * nstencil;
+                    for (long i = 0; i < n; ++i) {
+                        dst[i] = static_cast<float>(src[i]);
+                    }
+                }
+                // Below the finest MG level only the float copy is kept.
+                if (mglev > 0) {
+                    stencil.clear();
+                }
+            }
+        }
+    }
+#endif
 }
 
 void
@@ -215,6 +347,35 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
 {
     BL_PROFILE("MLABecLaplacian::Fapply()");
 
+#if (AMREX_SPACEDIM == 3)
+    if (!m_stencil.empty())
+    {
+        const MultiFab& stencil = m_stencil[amrlev][mglev];
+        const bool sp = stencil.empty();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(out, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            for (int n = 0; n < m_ncomp; ++n) {
+                if (sp) {
+                    amrex_mlabeclap_adotx_st_sp(BL_TO_FORTRAN_BOX(bx),
+                                                BL_TO_FORTRAN_N_ANYD(out[mfi],n),
+                                                BL_TO_FORTRAN_N_ANYD(in[mfi],n),
+                                                BL_TO_FORTRAN_ANYD(m_stencil_sp[amrlev][mglev][mfi]));
+                } else {
+                    amrex_mlabeclap_adotx_st(BL_TO_FORTRAN_BOX(bx),
+                                             BL_TO_FORTRAN_N_ANYD(out[mfi],n),
+                                             BL_TO_FORTRAN_N_ANYD(in[mfi],n),
+                                             BL_TO_FORTRAN_ANYD(stencil[mfi]));
+                }
+            }
+        }
+        return;
+    }
+#endif
+
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
                  const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
@@ -235,16 +396,86 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
                      const FArrayBox& byfab = bycoef[mfi];,
                      const FArrayBox& bzfab = bzcoef[mfi];);
 
-        amrex_mlabeclap_adotx(BL_TO_FORTRAN_BOX(bx),
-                              BL_TO_FORTRAN_ANYD(yfab),
-                              BL_TO_FORTRAN_ANYD(xfab),
-                              BL_TO_FORTRAN_ANYD(afab),
-                              AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
-                                           BL_TO_FORTRAN_ANYD(byfab),
-                                           BL_TO_FORTRAN_ANYD(bzfab)),
-                              dxinv, m_a_scalar, m_b_scalar);
+        for (int n = 0; n < m_ncomp; ++n)
+        {
+            amrex_mlabeclap_adotx(BL_TO_FORTRAN_BOX(bx),
+                                  BL_TO_FORTRAN_N_ANYD(yfab,n),
+                                  BL_TO_FORTRAN_N_ANYD(xfab,n),
+                                  BL_TO_FORTRAN_ANYD(afab),
+                                  AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
+                                               BL_TO_FORTRAN_ANYD(byfab),
+                                               BL_TO_FORTRAN_ANYD(bzfab)),
+                                  dxinv, m_a_scalar, m_b_scalar);
+        }
+
+    }
+}
 
+void
+MLABecLaplacian::FresRestriction (int amrlev, int mglev, MultiFab& crse,
+                                  const MultiFab& x, const MultiFab& b) const
+{
+    BL_PROFILE("MLABecLaplacian::FresRestriction()");
+
+#if (AMREX_SPACEDIM == 3)
+    if (!m_stencil.empty())
+    {
+        const MultiFab& stencil = m_stencil[amrlev][mglev];
+        const bool sp = stencil.empty();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(crse, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            for (int n = 0; n < m_ncomp; ++n) {
+                if (sp) {
+                    amrex_mlabeclap_resid_restrict_st_sp(BL_TO_FORTRAN_BOX(bx),
+                                                         BL_TO_FORTRAN_N_ANYD(crse[mfi],n),
+                                                         BL_TO_FORTRAN_N_ANYD(x[mfi],n),
+                                                         BL_TO_FORTRAN_N_ANYD(b[mfi],n),
+                                                         BL_TO_FORTRAN_ANYD(m_stencil_sp[amrlev][mglev][mfi]));
+                } else {
+                    amrex_mlabeclap_resid_restrict_st(BL_TO_FORTRAN_BOX(bx),
+                                                      BL_TO_FORTRAN_N_ANYD(crse[mfi],n),
+                                                      BL_TO_FORTRAN_N_ANYD(x[mfi],n),
+                                                      BL_TO_FORTRAN_N_ANYD(b[mfi],n),
+                                                      BL_TO_FORTRAN_ANYD(stencil[mfi]));
+                }
+            }
+        }
+        return;
+    }
+
+    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+    const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];
+    const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];
+    const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(crse, true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        for (int n = 0; n < m_ncomp; ++n)
+        {
+            amrex_mlabeclap_resid_restrict(BL_TO_FORTRAN_BOX(bx),
+                                           BL_TO_FORTRAN_N_ANYD(crse[mfi],n),
+                                           BL_TO_FORTRAN_N_ANYD(x[mfi],n),
+                                           BL_TO_FORTRAN_N_ANYD(b[mfi],n),
+                                           BL_TO_FORTRAN_ANYD(acoef[mfi]),
+                                           BL_TO_FORTRAN_ANYD(bxcoef[mfi]),
+                                           BL_TO_FORTRAN_ANYD(bycoef[mfi]),
+                                           BL_TO_FORTRAN_ANYD(bzcoef[mfi]),
+                                           dxinv, m_a_scalar, m_b_scalar);
+        }
     }
+#else
+    amrex::Abort("MLABecLaplacian::FresRestriction: only implemented in 3D");
+#endif
 }
 
 void
@@ -252,6 +483,33 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
 {
     BL_PROFILE("MLABecLaplacian::normalize()");
 
+#if (AMREX_SPACEDIM == 3)
+    if (!m_stencil.empty())
+    {
+        const MultiFab& stencil = m_stencil[amrlev][mglev];
+        const bool sp = stencil.empty();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(mf, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            for (int n = 0; n < m_ncomp; ++n) {
+                if (sp) {
+                    amrex_mlabeclap_normalize_st_sp(BL_TO_FORTRAN_BOX(bx),
+                                                    BL_TO_FORTRAN_N_ANYD(mf[mfi],n),
+                                                    BL_TO_FORTRAN_ANYD(m_stencil_sp[amrlev][mglev][mfi]));
+                } else {
+                    amrex_mlabeclap_normalize_st(BL_TO_FORTRAN_BOX(bx),
+                                                 BL_TO_FORTRAN_N_ANYD(mf[mfi],n),
+                                                 BL_TO_FORTRAN_ANYD(stencil[mfi]));
+                }
+            }
+        }
+        return;
+    }
+#endif
+
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
                  const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
@@ -271,13 +529,16 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
                      const FArrayBox& byfab = bycoef[mfi];,
                      const FArrayBox& bzfab = bzcoef[mfi];);
 
-        amrex_mlabeclap_normalize(BL_TO_FORTRAN_BOX(bx),
-                                  BL_TO_FORTRAN_ANYD(fab),
-                                  BL_TO_FORTRAN_ANYD(afab),
-                                  AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
-                                               BL_TO_FORTRAN_ANYD(byfab),
-                                               BL_TO_FORTRAN_ANYD(bzfab)),
-                                  dxinv, m_a_scalar, m_b_scalar);
+        for (int n = 0; n < m_ncomp; ++n)
+        {
+            amrex_mlabeclap_normalize(BL_TO_FORTRAN_BOX(bx),
+                                      BL_TO_FORTRAN_N_ANYD(fab,n),
+                                      BL_TO_FORTRAN_ANYD(afab),
+                                      AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
+                                                   BL_TO_FORTRAN_ANYD(byfab),
+                                                   BL_TO_FORTRAN_ANYD(bzfab)),
+                                      dxinv, m_a_scalar, m_b_scalar);
+        }
 
     }
 }
@@ -287,6 +548,38 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 {
     BL_PROFILE("MLABecLaplacian::Fsmooth()");
 
+#if (AMREX_SPACEDIM == 3)
+    if (!m_stencil.empty())
+    {
+        const MultiFab& stencil = m_stencil[amrlev][mglev];
+        const bool sp = !m_stencil_sp.empty() && !m_stencil_sp[amrlev][mglev].empty();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(sol,MFItInfo().EnableTiling().SetDynamic(true));
+             mfi.isValid(); ++mfi)
+        {
+            const Box& tbx = mfi.tilebox();
+            for (int n = 0; n < m_ncomp; ++n) {
+                if (sp) {
+                    amrex_mlabeclap_gsrb_st_sp(BL_TO_FORTRAN_BOX(tbx),
+                                               BL_TO_FORTRAN_N_ANYD(sol[mfi],n),
+                                               BL_TO_FORTRAN_N_ANYD(rhs[mfi],n),
+                                               BL_TO_FORTRAN_ANYD(m_stencil_sp[amrlev][mglev][mfi]),
+                                               redblack);
+                } else {
+                    amrex_mlabeclap_gsrb_st(BL_TO_FORTRAN_BOX(tbx),
+                                            BL_TO_FORTRAN_N_ANYD(sol[mfi],n),
+                                            BL_TO_FORTRAN_N_ANYD(rhs[mfi],n),
+                                            BL_TO_FORTRAN_ANYD(stencil[mfi]),
+                                            redblack);
+                }
+            }
+        }
+        return;
+    }
+#endif
+
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
                  const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
@@ -318,7 +611,7 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 #endif
 #endif
 
-    const int nc = 1;
+    const int nc = m_ncomp;
     const Real* h = m_geom[amrlev][mglev].CellSize();
 
 #ifdef _OPENMP
@@ -432,15 +725,18 @@ MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
     const Box& box = mfi.tilebox();
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
-    amrex_mlabeclap_flux(BL_TO_FORTRAN_BOX(box),
-                         AMREX_D_DECL(BL_TO_FORTRAN_ANYD(*flux[0]),
-                                      BL_TO_FORTRAN_ANYD(*flux[1]),
-                                      BL_TO_FORTRAN_ANYD(*flux[2])),
-                         BL_TO_FORTRAN_ANYD(sol),
-                         AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bx),
-                                      BL_TO_FORTRAN_ANYD(by),
-                                      BL_TO_FORTRAN_ANYD(bz)),
-                         dxinv, m_b_scalar, face_only);
+    for (int n = 0; n < m_ncomp; ++n)
+    {
+        amrex_mlabeclap_flux(BL_TO_FORTRAN_BOX(box),
+                             AMREX_D_DECL(BL_TO_FORTRAN_N_ANYD(*flux[0],n),
+                                          BL_TO_FORTRAN_N_ANYD(*flux[1],n),
+                                          BL_TO_FORTRAN_N_ANYD(*flux[2],n)),
+                             BL_TO_FORTRAN_N_ANYD(sol,n),
+                             AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bx),
+                                          BL_TO_FORTRAN_ANYD(by),
+                                          BL_TO_FORTRAN_ANYD(bz)),
+                             dxinv, m_b_scalar, face_only);
+    }
 }
 
 }
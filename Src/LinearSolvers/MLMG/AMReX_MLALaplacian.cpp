@@ -48,6 +48,7 @@ MLALaplacian::setScalars (Real a, Real b)
 {
     m_a_scalar = a;
     m_b_scalar = b;
+    m_needs_update = true;
     if (a == 0.0)
     {
         for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
@@ -61,6 +62,7 @@ void
 MLALaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
+    m_needs_update = true;
 }
 
 void
@@ -0,0 +1,871 @@
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <AMReX_MLAMG.H>
+#include <AMReX_BoxIterator.H>
+#include <AMReX_ParallelDescriptor.H>
+
+namespace amrex {
+
+namespace {
+
+constexpr int max_amg_levels = 20;
+// Coarsest levels larger than this are smoothed instead of factored.
+constexpr int max_dense_size = 2048;
+
+inline Real
+dot (const Vector<Real>& a, const Vector<Real>& b)
+{
+    Real r = 0.0;
+    for (long i = 0, n = a.size(); i < n; ++i) {
+        r += a[i]*b[i];
+    }
+    return r;
+}
+
+template <class M>
+void spmv (const M& A, const Real* x, Real* y)
+{
+    for (int i = 0; i < A.nrows; ++i) {
+        Real s = 0.0;
+        for (int n = A.ptr[i]; n < A.ptr[i+1]; ++n) {
+            s += A.val[n]*x[A.col[n]];
+        }
+        y[i] = s;
+    }
+}
+
+template <class M>
+void residual (const M& A, const Real* x, const Real* b, Real* r)
+{
+    for (int i = 0; i < A.nrows; ++i) {
+        Real s = b[i];
+        for (int n = A.ptr[i]; n < A.ptr[i+1]; ++n) {
+            s -= A.val[n]*x[A.col[n]];
+        }
+        r[i] = s;
+    }
+}
+
+template <class M>
+void gaussSeidel (const M& A, Real* x, const Real* b, bool forward)
+{
+    for (int m = 0; m < A.nrows; ++m)
+    {
+        const int i = forward ? m : A.nrows-1-m;
+        Real s = b[i];
+        Real d = 0.0;
+        for (int n = A.ptr[i]; n < A.ptr[i+1]; ++n) {
+            const int j = A.col[n];
+            if (j == i) {
+                d += A.val[n];
+            } else {
+                s -= A.val[n]*x[j];
+            }
+        }
+        if (d != 0.0) x[i] = s/d;
+    }
+}
+
+template <class M>
+Real diagonal (const M& A, int i)
+{
+    Real d = 0.0;
+    for (int n = A.ptr[i]; n < A.ptr[i+1]; ++n) {
+        if (A.col[n] == i) d += A.val[n];
+    }
+    return d;
+}
+
+template <class M>
+M transpose (const M& A)
+{
+    M T;
+    T.nrows = A.ncols;
+    T.ncols = A.nrows;
+    T.ptr.assign(T.nrows+1, 0);
+    for (int c : A.col) {
+        ++T.ptr[c+1];
+    }
+    for (int i = 0; i < T.nrows; ++i) {
+        T.ptr[i+1] += T.ptr[i];
+    }
+    T.col.resize(A.col.size());
+    T.val.resize(A.val.size());
+    Vector<int> pos(T.ptr.begin(), T.ptr.end()-1);
+    for (int i = 0; i < A.nrows; ++i) {
+        for (int n = A.ptr[i]; n < A.ptr[i+1]; ++n) {
+            const int p = pos[A.col[n]]++;
+            T.col[p] = i;
+            T.val[p] = A.val[n];
+        }
+    }
+    return T;
+}
+
+// Gustavson's row-by-row product.
+template <class M>
+M multiply (const M& A, const M& B)
+{
+    M C;
+    C.nrows = A.nrows;
+    C.ncols = B.ncols;
+    C.ptr.resize(C.nrows+1);
+    C.ptr[0] = 0;
+    Vector<int> marker(B.ncols, -1);
+    for (int i = 0; i < A.nrows; ++i)
+    {
+        const int row_start = C.col.size();
+        for (int na = A.ptr[i]; na < A.ptr[i+1]; ++na)
+        {
+            const int k = A.col[na];
+            const Real a = A.val[na];
+            for (int nb = B.ptr[k]; nb < B.ptr[k+1]; ++nb)
+            {
+                const int j = B.col[nb];
+                if (marker[j] < row_start) {
+                    marker[j] = C.col.size();
+                    C.col.push_back(j);
+                    C.val.push_back(a*B.val[nb]);
+                } else {
+                    C.val[marker[j]] += a*B.val[nb];
+                }
+            }
+        }
+        C.ptr[i+1] = C.col.size();
+    }
+    return C;
+}
+
+//
+// Greedy aggregation on the strength graph |a_ij| >= theta sqrt(a_ii a_jj):
+// roots whose strong neighbors are all free take them as an aggregate,
+// then the remaining nodes join the aggregate they are most strongly
+// connected to.  Returns the number of aggregates.
+//
+template <class M>
+int aggregate (const M& A, Real theta, Vector<int>& agg)
+{
+    const int n = A.nrows;
+    Vector<Real> d(n);
+    for (int i = 0; i < n; ++i) {
+        d[i] = std::abs(diagonal(A,i));
+    }
+    auto strong = [&] (int i, int nz) {
+        const int j = A.col[nz];
+        return j != i && std::abs(A.val[nz]) >= theta*std::sqrt(d[i]*d[j]);
+    };
+
+    agg.assign(n, -1);
+    int nagg = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (agg[i] >= 0) continue;
+        bool free = true;
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1] && free; ++nz) {
+            if (strong(i,nz) && agg[A.col[nz]] >= 0) free = false;
+        }
+        if (!free) continue;
+        agg[i] = nagg;
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1]; ++nz) {
+            if (strong(i,nz)) agg[A.col[nz]] = nagg;
+        }
+        ++nagg;
+    }
+
+    const Vector<int> agg1 = agg;
+    for (int i = 0; i < n; ++i)
+    {
+        if (agg[i] >= 0) continue;
+        Real amax = 0.0;
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1]; ++nz) {
+            const int j = A.col[nz];
+            if (strong(i,nz) && agg1[j] >= 0 && std::abs(A.val[nz]) > amax) {
+                amax = std::abs(A.val[nz]);
+                agg[i] = agg1[j];
+            }
+        }
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (agg[i] >= 0) continue;
+        agg[i] = nagg;
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1]; ++nz) {
+            if (strong(i,nz) && agg[A.col[nz]] < 0) agg[A.col[nz]] = nagg;
+        }
+        ++nagg;
+    }
+
+    return nagg;
+}
+
+//
+// P = (I - omega D^{-1} A) P_tent, with the piecewise constant tentative
+// prolongation and omega = 4/(3 rho), rho a Gershgorin bound on D^{-1} A.
+//
+template <class M>
+M smoothedProlongation (const M& A, const Vector<int>& agg, int nagg)
+{
+    const int n = A.nrows;
+    Vector<Real> dinv(n, 0.0);
+    Real rho = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        const Real d = diagonal(A,i);
+        if (d == 0.0) continue;
+        dinv[i] = 1.0/d;
+        Real s = 0.0;
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1]; ++nz) {
+            s += std::abs(A.val[nz]);
+        }
+        rho = std::max(rho, s*std::abs(dinv[i]));
+    }
+    const Real omega = (rho > 0.0) ? 4.0/(3.0*rho) : 0.0;
+
+    M P;
+    P.nrows = n;
+    P.ncols = nagg;
+    P.ptr.resize(n+1);
+    P.ptr[0] = 0;
+    Vector<int> marker(nagg, -1);
+    for (int i = 0; i < n; ++i)
+    {
+        const int row_start = P.col.size();
+        marker[agg[i]] = row_start;
+        P.col.push_back(agg[i]);
+        P.val.push_back(1.0);
+        const Real w = omega*dinv[i];
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1]; ++nz)
+        {
+            const int c = agg[A.col[nz]];
+            if (marker[c] < row_start) {
+                marker[c] = P.col.size();
+                P.col.push_back(c);
+                P.val.push_back(-w*A.val[nz]);
+            } else {
+                P.val[marker[c]] -= w*A.val[nz];
+            }
+        }
+        P.ptr[i+1] = P.col.size();
+    }
+    return P;
+}
+
+}
+
+MLAMG::MLAMG (const BoxArray& a_grids, const DistributionMapping& a_dmap,
+              const Geometry& a_geom, MPI_Comm a_comm)
+    : comm(a_comm),
+      grids(a_grids),
+      dmap(a_dmap),
+      geom(a_geom),
+      acoefs(a_grids, a_dmap, 1, 0)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcoefs[idim].define(amrex::convert(grids,IntVect::TheDimensionVector(idim)), dmap, 1, 0);
+        m_lobc[idim] = LinOpBCType::Dirichlet;
+        m_hibc[idim] = LinOpBCType::Dirichlet;
+    }
+    acoefs.setVal(0.0);
+    for (auto& b : bcoefs) {
+        b.setVal(1.0);
+    }
+
+    defineOrdering();
+}
+
+void
+MLAMG::setScalars (Real sa, Real sb)
+{
+    scalar_a = sa;
+    scalar_b = sb;
+    coeffs_changed = true;
+}
+
+void
+MLAMG::setACoeffs (const MultiFab& alpha)
+{
+    MultiFab::Copy(acoefs, alpha, 0, 0, 1, 0);
+    coeffs_changed = true;
+}
+
+void
+MLAMG::setBCoeffs (const std::array<const MultiFab*,AMREX_SPACEDIM>& beta)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        MultiFab::Copy(bcoefs[idim], *beta[idim], 0, 0, 1, 0);
+    }
+    coeffs_changed = true;
+}
+
+void
+MLAMG::setDomainBC (const std::array<LinOpBCType,AMREX_SPACEDIM>& lobc,
+                    const std::array<LinOpBCType,AMREX_SPACEDIM>& hibc,
+                    const RealVect& cf_bcl)
+{
+    m_lobc = lobc;
+    m_hibc = hibc;
+    m_cf_bcl = cf_bcl;
+    coeffs_changed = true;
+}
+
+void
+MLAMG::defineOrdering ()
+{
+    Vector<int> my_boxes;
+    nlocal = 0;
+    for (MFIter mfi(acoefs); mfi.isValid(); ++mfi) {
+        my_boxes.push_back(mfi.index());
+        nlocal += mfi.validbox().numPts();
+    }
+
+#ifdef BL_USE_MPI
+    int nprocs;
+    MPI_Comm_size(comm, &nprocs);
+    MPI_Comm_rank(comm, &myproc);
+
+    int my_nboxes = my_boxes.size();
+    Vector<int> nboxes(nprocs);
+    MPI_Allgather(&my_nboxes, 1, MPI_INT, nboxes.data(), 1, MPI_INT, comm);
+
+    Vector<int> bdispls(nprocs, 0);
+    for (int p = 1; p < nprocs; ++p) {
+        bdispls[p] = bdispls[p-1] + nboxes[p-1];
+    }
+    box_order.resize(bdispls[nprocs-1] + nboxes[nprocs-1]);
+    MPI_Allgatherv(my_boxes.data(), my_nboxes, MPI_INT,
+                   box_order.data(), nboxes.data(), bdispls.data(), MPI_INT, comm);
+#else
+    const int nprocs = 1;
+    myproc = 0;
+    Vector<int> nboxes(1, my_boxes.size());
+    Vector<int> bdispls(1, 0);
+    box_order = my_boxes;
+#endif
+
+    if (box_order.size() != grids.size()) {
+        amrex::Abort("MLAMG: the communicator does not cover all the grids");
+    }
+
+    box_offset.resize(grids.size());
+    recv_counts.assign(nprocs, 0);
+    recv_displs.assign(nprocs, 0);
+    long offset = 0;
+    for (int p = 0; p < nprocs; ++p)
+    {
+        long cnt = 0;
+        for (int ib = bdispls[p]; ib < bdispls[p]+nboxes[p]; ++ib) {
+            const int i = box_order[ib];
+            box_offset[i] = offset + cnt;
+            cnt += grids[i].numPts();
+        }
+        recv_counts[p] = cnt;
+        recv_displs[p] = offset;
+        offset += cnt;
+    }
+    nglobal = offset;
+
+    if (nglobal*(2*AMREX_SPACEDIM+1) > std::numeric_limits<int>::max()) {
+        amrex::Abort("MLAMG: the bottom problem is too large for a single process");
+    }
+}
+
+//
+// Cells are numbered box by box in the global ordering, and in each box
+// in the order of Box::index.  iv must be in the grids; ibox is a guess.
+//
+long
+MLAMG::globalIndex (const IntVect& iv, int ibox) const
+{
+    if (!grids[ibox].contains(iv)) {
+        ibox = grids.intersections(Box(iv,iv), true, 0)[0].first;
+    }
+    return box_offset[ibox] + grids[ibox].index(iv);
+}
+
+void
+MLAMG::gather (const Vector<Real>& local, Vector<Real>& global, int nper) const
+{
+    if (myproc == 0) {
+        global.resize(nglobal*nper);
+    }
+#ifdef BL_USE_MPI
+    const int nprocs = recv_counts.size();
+    Vector<int> counts(nprocs), displs(nprocs);
+    for (int p = 0; p < nprocs; ++p) {
+        counts[p] = recv_counts[p]*nper;
+        displs[p] = recv_displs[p]*nper;
+    }
+    MPI_Gatherv(const_cast<Real*>(local.data()), nlocal*nper,
+                ParallelDescriptor::Mpi_typemap<Real>::type(),
+                global.data(), counts.data(), displs.data(),
+                ParallelDescriptor::Mpi_typemap<Real>::type(), 0, comm);
+#else
+    std::copy(local.begin(), local.end(), global.begin());
+#endif
+}
+
+void
+MLAMG::scatter (const Vector<Real>& global, Vector<Real>& local) const
+{
+    local.resize(nlocal);
+#ifdef BL_USE_MPI
+    MPI_Scatterv(const_cast<Real*>(global.data()),
+                 const_cast<int*>(recv_counts.data()), const_cast<int*>(recv_displs.data()),
+                 ParallelDescriptor::Mpi_typemap<Real>::type(),
+                 local.data(), nlocal,
+                 ParallelDescriptor::Mpi_typemap<Real>::type(), 0, comm);
+#else
+    std::copy(global.begin(), global.end(), local.begin());
+#endif
+}
+
+//
+// Row of each local cell: the diagonal followed by the coupling to the low
+// and high neighbors in each direction.  Boundaries are folded into the
+// diagonal the same way HypreABecLap2 does with linear extrapolation.
+//
+void
+MLAMG::assembleStencil (Vector<Real>& st) const
+{
+    constexpr int nst = 2*AMREX_SPACEDIM+1;
+    st.resize(nlocal*nst);
+
+    const Box& domain = geom.Domain();
+    const Real* dx = geom.CellSize();
+
+    long k = 0;
+    for (MFIter mfi(acoefs); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const FArrayBox& afab = acoefs[mfi];
+        for (BoxIterator bit(vbx); bit.ok(); ++bit, ++k)
+        {
+            const IntVect& iv = bit();
+            Real* s = &st[k*nst];
+            s[0] = scalar_a * afab(iv);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                const FArrayBox& bfab = bcoefs[idim][mfi];
+                const Real fac = scalar_b / (dx[idim]*dx[idim]);
+                for (int side = 0; side < 2; ++side)
+                {
+                    Real& off = s[1+2*idim+side];
+                    off = 0.0;
+
+                    IntVect face = iv;
+                    IntVect nb = iv;
+                    if (side == 0) {
+                        nb.shift(idim,-1);
+                    } else {
+                        face.shift(idim,1);
+                        nb.shift(idim,1);
+                    }
+                    const Real bf = bfab(face);
+
+                    if (!domain.contains(nb))
+                    {
+                        if (geom.isPeriodic(idim)) {
+                            nb.shift(idim, side == 0 ? domain.length(idim) : -domain.length(idim));
+                        } else {
+                            const LinOpBCType bct = (side == 0) ? m_lobc[idim] : m_hibc[idim];
+                            if (bct == LinOpBCType::Dirichlet || bct == LinOpBCType::reflect_odd) {
+                                s[0] += 2.0*fac*bf;
+                            } else if (bct != LinOpBCType::Neumann) {
+                                amrex::Abort("MLAMG: unsupported boundary type");
+                            }
+                            continue;
+                        }
+                    }
+
+                    if (vbx.contains(nb) || grids.contains(nb)) {
+                        s[0] += fac*bf;
+                        off = -fac*bf;
+                    } else {
+                        s[0] += bf * (scalar_b/dx[idim]) / (0.5*dx[idim] + m_cf_bcl[idim]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+MLAMG::buildMatrix (CSR& A) const
+{
+    constexpr int nst = 2*AMREX_SPACEDIM+1;
+    const Box& domain = geom.Domain();
+
+    A.nrows = nglobal;
+    A.ncols = nglobal;
+    A.ptr.resize(nglobal+1);
+    A.col.clear();
+    A.val.clear();
+    A.col.reserve(nglobal*nst);
+    A.val.reserve(nglobal*nst);
+    A.ptr[0] = 0;
+
+    std::array<std::pair<int,Real>,nst> row;
+    long k = 0;
+    for (int i : box_order)
+    {
+        for (BoxIterator bit(grids[i]); bit.ok(); ++bit, ++k)
+        {
+            const IntVect& iv = bit();
+            const Real* s = &stencil[k*nst];
+            int nnz = 0;
+            row[nnz++] = std::make_pair(int(k), s[0]);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                for (int side = 0; side < 2; ++side) {
+                    const Real off = s[1+2*idim+side];
+                    if (off == 0.0) continue;
+                    IntVect nb = iv;
+                    nb.shift(idim, side == 0 ? -1 : 1);
+                    if (!domain.contains(nb)) {
+                        nb.shift(idim, side == 0 ? domain.length(idim) : -domain.length(idim));
+                    }
+                    row[nnz++] = std::make_pair(int(globalIndex(nb,i)), off);
+                }
+            }
+            // Short periodic directions can make a cell its own neighbor.
+            std::sort(row.begin(), row.begin()+nnz,
+                      [] (const std::pair<int,Real>& a, const std::pair<int,Real>& b)
+                      { return a.first < b.first; });
+            for (int n = 0; n < nnz; ++n) {
+                if (n > 0 && row[n].first == row[n-1].first) {
+                    A.val.back() += row[n].second;
+                } else {
+                    A.col.push_back(row[n].first);
+                    A.val.push_back(row[n].second);
+                }
+            }
+            A.ptr[k+1] = A.col.size();
+        }
+    }
+}
+
+void
+MLAMG::setup ()
+{
+    BL_PROFILE("MLAMG::setup()");
+
+    constexpr int nst = 2*AMREX_SPACEDIM+1;
+
+    Vector<Real> st_local, st;
+    assembleStencil(st_local);
+    gather(st_local, st, nst);
+    coeffs_changed = false;
+
+    if (myproc != 0) return;
+
+    if (!amg_levels.empty() && st == stencil)
+    {
+        if (verbose >= 2) {
+            amrex::Print(0, comm) << "MLAMG: matrix unchanged, reusing setup\n";
+        }
+        return;
+    }
+
+    std::swap(stencil, st);
+    ++num_setups;
+
+    amg_levels.clear();
+    amg_levels.resize(1);
+    buildMatrix(amg_levels[0].A);
+
+    while (int(amg_levels.size()) < max_amg_levels)
+    {
+        const CSR& A = amg_levels.back().A;
+        if (A.nrows <= max_coarse_size) break;
+
+        Vector<int> agg;
+        const int nagg = aggregate(A, strength_threshold, agg);
+        if (nagg == 0 || nagg >= A.nrows) break;
+
+        CSR P = smoothedProlongation(A, agg, nagg);
+        CSR R = transpose(P);
+        CSR Ac = multiply(R, multiply(A, P));
+
+        amg_levels.back().P = std::move(P);
+        amg_levels.back().R = std::move(R);
+        amg_levels.resize(amg_levels.size()+1);
+        amg_levels.back().A = std::move(Ac);
+    }
+
+    long nnz = 0;
+    for (auto& lev : amg_levels) {
+        const int n = lev.A.nrows;
+        lev.x.resize(n);
+        lev.b.resize(n);
+        lev.r.resize(n);
+        nnz += lev.A.col.size();
+    }
+
+    buildCoarseLU();
+
+    if (verbose >= 1) {
+        amrex::Print(0, comm) << "MLAMG: " << amg_levels.size() << " levels, "
+                       << nglobal << " -> " << amg_levels.back().A.nrows << " unknowns"
+                       << ", operator complexity "
+                       << double(nnz)/double(amg_levels[0].A.col.size()) << "\n";
+    }
+}
+
+//
+// Dense LU with partial pivoting of the coarsest operator.  A pivot that
+// vanishes relative to the matrix (the null space of a singular problem)
+// is dropped, which pins the corresponding unknown to zero.  The solve
+// then removes the mean so that it matches the Krylov bottom solvers.
+//
+void
+MLAMG::buildCoarseLU ()
+{
+    const CSR& A = amg_levels.back().A;
+    const int n = A.nrows;
+
+    coarse_lu.clear();
+    coarse_piv.clear();
+    singular = false;
+    if (n > max_dense_size) return;
+
+    coarse_lu.assign(long(n)*n, 0.0);
+    coarse_piv.resize(n);
+    Real amax = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int nz = A.ptr[i]; nz < A.ptr[i+1]; ++nz) {
+            coarse_lu[long(i)*n+A.col[nz]] += A.val[nz];
+            amax = std::max(amax, std::abs(A.val[nz]));
+        }
+    }
+    const Real tol = amax * 1.e-10;
+
+    Real* lu = coarse_lu.data();
+    for (int k = 0; k < n; ++k)
+    {
+        int p = k;
+        for (int i = k+1; i < n; ++i) {
+            if (std::abs(lu[long(i)*n+k]) > std::abs(lu[long(p)*n+k])) p = i;
+        }
+        coarse_piv[k] = p;
+        if (p != k) {
+            for (int j = 0; j < n; ++j) {
+                std::swap(lu[long(k)*n+j], lu[long(p)*n+j]);
+            }
+        }
+        const Real piv = lu[long(k)*n+k];
+        if (std::abs(piv) <= tol) {
+            singular = true;
+            for (int i = k; i < n; ++i) {
+                lu[long(i)*n+k] = 0.0;
+            }
+            continue;
+        }
+        for (int i = k+1; i < n; ++i)
+        {
+            const Real l = lu[long(i)*n+k] / piv;
+            lu[long(i)*n+k] = l;
+            if (l == 0.0) continue;
+            for (int j = k+1; j < n; ++j) {
+                lu[long(i)*n+j] -= l*lu[long(k)*n+j];
+            }
+        }
+    }
+}
+
+void
+MLAMG::coarseSolve (Vector<Real>& x, const Vector<Real>& b) const
+{
+    const CSR& A = amg_levels.back().A;
+    const int n = A.nrows;
+
+    if (coarse_lu.empty())
+    {
+        std::fill(x.begin(), x.end(), 0.0);
+        for (int i = 0; i < 20; ++i) {
+            gaussSeidel(A, x.data(), b.data(), true);
+            gaussSeidel(A, x.data(), b.data(), false);
+        }
+        return;
+    }
+
+    const Real* lu = coarse_lu.data();
+    x = b;
+    for (int k = 0; k < n; ++k) {
+        std::swap(x[k], x[coarse_piv[k]]);
+    }
+    for (int i = 1; i < n; ++i) {
+        Real s = x[i];
+        for (int j = 0; j < i; ++j) {
+            s -= lu[long(i)*n+j]*x[j];
+        }
+        x[i] = s;
+    }
+    for (int i = n-1; i >= 0; --i) {
+        const Real d = lu[long(i)*n+i];
+        if (d == 0.0) {
+            x[i] = 0.0;
+        } else {
+            Real s = x[i];
+            for (int j = i+1; j < n; ++j) {
+                s -= lu[long(i)*n+j]*x[j];
+            }
+            x[i] = s/d;
+        }
+    }
+}
+
+//
+// Symmetric V-cycle: forward Gauss-Seidel on the way down and backward on
+// the way up, so that it can precondition CG.
+//
+void
+MLAMG::vcycle (int lev)
+{
+    AMGLevel& L = amg_levels[lev];
+
+    if (lev == int(amg_levels.size())-1) {
+        coarseSolve(L.x, L.b);
+        return;
+    }
+
+    AMGLevel& C = amg_levels[lev+1];
+
+    std::fill(L.x.begin(), L.x.end(), 0.0);
+    gaussSeidel(L.A, L.x.data(), L.b.data(), true);
+    residual(L.A, L.x.data(), L.b.data(), L.r.data());
+    spmv(L.R, L.r.data(), C.b.data());
+
+    vcycle(lev+1);
+
+    spmv(L.P, C.x.data(), L.r.data());
+    for (int i = 0; i < L.A.nrows; ++i) {
+        L.x[i] += L.r[i];
+    }
+    gaussSeidel(L.A, L.x.data(), L.b.data(), false);
+}
+
+int
+MLAMG::solve (MultiFab& soln, const MultiFab& rhs, Real rel_tol, Real abs_tol, int max_iter)
+{
+    BL_PROFILE("MLAMG::solve()");
+
+    if (coeffs_changed) setup();
+
+    Vector<Real> b_local(nlocal);
+    {
+        long k = 0;
+        for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+            const FArrayBox& fab = rhs[mfi];
+            for (BoxIterator bit(mfi.validbox()); bit.ok(); ++bit) {
+                b_local[k++] = fab(bit());
+            }
+        }
+    }
+
+    Vector<Real> x, r;
+    gather(b_local, r, 1);
+
+    int ret = 0;
+    if (myproc == 0) {
+        ret = pcg(x, r, rel_tol, abs_tol, max_iter);
+    }
+#ifdef BL_USE_MPI
+    MPI_Bcast(&ret, 1, MPI_INT, 0, comm);
+    MPI_Bcast(&num_setups, 1, MPI_INT, 0, comm);
+#endif
+
+    Vector<Real> x_local;
+    scatter(x, x_local);
+
+    long k = 0;
+    for (MFIter mfi(soln); mfi.isValid(); ++mfi) {
+        FArrayBox& fab = soln[mfi];
+        for (BoxIterator bit(mfi.validbox()); bit.ok(); ++bit) {
+            fab(bit()) = x_local[k++];
+        }
+    }
+
+    return ret;
+}
+
+//
+// AMG preconditioned CG on the whole problem, on the first process only.
+// r holds the right-hand side on entry.
+//
+int
+MLAMG::pcg (Vector<Real>& x, Vector<Real>& r, Real rel_tol, Real abs_tol, int max_iter)
+{
+    AMGLevel& L0 = amg_levels[0];
+    const CSR& A = L0.A;
+    x.assign(nglobal, 0.0);
+    Vector<Real> z(nglobal), p(nglobal), q(nglobal);
+
+    const Real rnorm0 = std::sqrt(dot(r,r));
+    const Real eps = std::max(rel_tol*rnorm0, abs_tol);
+    Real rnorm = rnorm0;
+
+    int ret = 0;
+    int iter = 0;
+    if (rnorm0 > 0.0)
+    {
+        ret = 1;
+        Real rz = 0.0;
+        for (iter = 1; iter <= max_iter; ++iter)
+        {
+            L0.b = r;
+            vcycle(0);
+            z = L0.x;
+            if (singular) {
+                const Real zmean = std::accumulate(z.begin(), z.end(), Real(0.0)) / nglobal;
+                for (auto& v : z) {
+                    v -= zmean;
+                }
+            }
+
+            const Real rz_new = dot(r,z);
+            if (iter == 1) {
+                p = z;
+            } else {
+                const Real beta = rz_new/rz;
+                for (long i = 0; i < nglobal; ++i) {
+                    p[i] = z[i] + beta*p[i];
+                }
+            }
+            rz = rz_new;
+
+            spmv(A, p.data(), q.data());
+            const Real pq = dot(p,q);
+            if (pq == 0.0) break;
+            const Real alpha = rz/pq;
+            for (long i = 0; i < nglobal; ++i) {
+                x[i] += alpha*p[i];
+                r[i] -= alpha*q[i];
+            }
+
+            rnorm = std::sqrt(dot(r,r));
+            if (verbose >= 3) {
+                amrex::Print(0, comm) << "MLAMG: Iteration " << iter << " resid/resid0 = "
+                                      << rnorm/rnorm0 << "\n";
+            }
+            if (rnorm <= eps) {
+                ret = 0;
+                break;
+            }
+        }
+    }
+
+    if (verbose >= 1) {
+        amrex::Print(0, comm) << "MLAMG: Final Iter. " << std::min(iter,max_iter)
+                              << " resid, resid/resid0 = " << rnorm << ", "
+                              << (rnorm0 > 0.0 ? rnorm/rnorm0 : 0.0) << "\n";
+    }
+
+    return ret;
+}
+
+}
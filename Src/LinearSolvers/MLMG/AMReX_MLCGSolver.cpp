@@ -47,12 +47,86 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0);
 }
 
+//
+// ss(n) = xx(n) + sign*a[n]*yy(n) for every component n.
+//
+void
+sxay (MultiFab&           ss,
+      const MultiFab&     xx,
+      const Vector<Real>& a,
+      const MultiFab&     yy,
+      Real                sign = 1.0)
+{
+    BL_PROFILE("CGSolver::sxay()");
+
+    const int ncomp = ss.nComp();
+    for (int n = 0; n < ncomp; ++n) {
+        MultiFab::LinComb(ss, 1.0, xx, n, sign*a[n], yy, n, n, 1, 0);
+    }
+}
+
+Real
+maxval (const Vector<Real>& v)
+{
+    return *std::max_element(v.begin(), v.end());
+}
+
+// Largest relative residual over the components that started nonzero.
+Real
+relerr (const Vector<Real>& rnorm, const Vector<Real>& rnorm0)
+{
+    Real r = 0.0;
+    for (int n = 0, N = rnorm.size(); n < N; ++n) {
+        if (rnorm0[n] > 0) r = std::max(r, rnorm[n]/rnorm0[n]);
+    }
+    return r;
+}
+
+//
+// Solve the n x n row-major system A X = B in place by Gaussian elimination
+// with partial pivoting; B has nrhs columns.  A is overwritten.  Returns
+// false if A is singular.
+//
+bool
+dense_solve (int n, Vector<Real>& A, Real* B, int nrhs)
+{
+    for (int k = 0; k < n; ++k)
+    {
+        int piv = k;
+        for (int i = k+1; i < n; ++i) {
+            if (std::abs(A[i*n+k]) > std::abs(A[piv*n+k])) piv = i;
+        }
+        if (A[piv*n+k] == 0) return false;
+        if (piv != k) {
+            for (int j = 0; j < n; ++j)    std::swap(A[k*n+j], A[piv*n+j]);
+            for (int j = 0; j < nrhs; ++j) std::swap(B[k*nrhs+j], B[piv*nrhs+j]);
+        }
+        for (int i = k+1; i < n; ++i)
+        {
+            const Real f = A[i*n+k] / A[k*n+k];
+            for (int j = k; j < n; ++j)    A[i*n+j] -= f*A[k*n+j];
+            for (int j = 0; j < nrhs; ++j) B[i*nrhs+j] -= f*B[k*nrhs+j];
+        }
+    }
+    for (int k = n-1; k >= 0; --k)
+    {
+        for (int j = 0; j < nrhs; ++j)
+        {
+            Real x = B[k*nrhs+j];
+            for (int i = k+1; i < n; ++i) x -= A[k*n+i]*B[i*nrhs+j];
+            B[k*nrhs+j] = x / A[k*n+k];
+        }
+    }
+    return true;
+}
+
 }
 
-MLCGSolver::MLCGSolver (MLLinOp& _lp)
+MLCGSolver::MLCGSolver (MLLinOp& _lp, Solver _solver)
     : Lp(_lp),
       amrlev(0),
-      mglev(_lp.NMGLevels(0)-1)
+      mglev(_lp.NMGLevels(0)-1),
+      solver(_solver)
 {
 }
 
@@ -60,13 +134,46 @@ MLCGSolver::~MLCGSolver ()
 {
 }
 
+void
+MLCGSolver::setSStep (int _sstep)
+{
+    if (_sstep < 1 || _sstep > SSTEP_MAX) {
+        amrex::Abort("MLCGSolver::setSStep: s must be in [1,SSTEP_MAX]");
+    }
+    sstep = _sstep;
+}
+
 int
 MLCGSolver::solve (MultiFab&       sol,
                    const MultiFab& rhs,
                    Real            eps_rel,
                    Real            eps_abs)
 {
-    BL_PROFILE_REGION("MLCGSolver::solve()");
+    switch (solver)
+    {
+    case Solver::BiCGStab:
+        return solve_bicgstab(sol, rhs, eps_rel, eps_abs);
+    case Solver::CG:
+        return solve_cg(sol, rhs, eps_rel, eps_abs);
+    case Solver::PipeBiCGStab:
+        return solve_pipe_bicgstab(sol, rhs, eps_rel, eps_abs);
+    case Solver::PipeCG:
+        return solve_pipe_cg(sol, rhs, eps_rel, eps_abs);
+    case Solver::SStepCG:
+        return solve_sstep_cg(sol, rhs, eps_rel, eps_abs);
+    default:
+        amrex::Abort("MLCGSolver::solve: unknown solver");
+    }
+    return -1;
+}
+
+int
+MLCGSolver::solve_bicgstab (MultiFab&       sol,
+                            const MultiFab& rhs,
+                            Real            eps_rel,
+                            Real            eps_abs)
+{
+    BL_PROFILE_REGION("MLCGSolver::bicgstab");
 
     const int nghost = sol.nGrow(), ncomp = sol.nComp();
 
@@ -96,70 +203,98 @@ MLCGSolver::solve (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real rnorm = norm_inf(r);
-    const Real rnorm0   = rnorm;
+    // Each component is an independent system with its own scalars and
+    // convergence test; a converged component is frozen.
+    Vector<Real> rnorm(ncomp);
+    norm_inf(r, rnorm.data());
+    const Vector<Real> rnorm0 = rnorm;
+
+    Vector<int> active(ncomp);
+    int nactive = 0;
+    for (int n = 0; n < ncomp; ++n) {
+        active[n] = !(rnorm0[n] == 0 || rnorm0[n] < eps_abs);
+        nactive += active[n];
+    }
 
     if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
     {
-        std::cout << "MLCGSolver_BiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+        std::cout << "MLCGSolver_BiCGStab: Initial error (error0) =        " << maxval(rnorm0) << '\n';
     }
     int ret = 0, nit = 1;
-    Real rho_1 = 0, alpha = 0, omega = 0;
+    Vector<Real> rho(ncomp), rho_1(ncomp,0), alpha(ncomp,0), omega(ncomp,0), beta(ncomp);
+    Vector<Real> rhTv(ncomp), tvals(2*ncomp);
 
-    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    iter = 0;
+
+    if ( nactive == 0 )
     {
         if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
 	{
             std::cout << "MLCGSolver_BiCGStab: niter = 0,"
-                      << ", rnorm = " << rnorm 
+                      << ", rnorm = " << maxval(rnorm)
                       << ", eps_abs = " << eps_abs << std::endl;
 	}
         return ret;
     }
 
+    auto converged = [&] (int n) {
+        return rnorm[n] < eps_rel*rnorm0[n] || rnorm[n] < eps_abs;
+    };
+
     for (; nit <= maxiter; ++nit)
     {
-        const Real rho = dotxy(rh,r);
-        if ( rho == 0 ) 
-	{
-            ret = 1; break;
-	}
+        dotxy(rh,r,rho.data());
+        for (int n = 0; n < ncomp; ++n) {
+            if ( active[n] && rho[n] == 0 ) ret = 1;
+        }
+        if ( ret != 0 ) break;
         if ( nit == 1 )
         {
             MultiFab::Copy(p,r,0,0,ncomp,0);
         }
         else
         {
-            const Real beta = (rho/rho_1)*(alpha/omega);
-            sxay(p, p, -omega, v);
-            sxay(p, r,   beta, p);
+            for (int n = 0; n < ncomp; ++n) {
+                beta[n] = active[n] ? (rho[n]/rho_1[n])*(alpha[n]/omega[n]) : 0.0;
+            }
+            sxay(p, p, omega, v, -1.0);
+            sxay(p, r, beta, p);
         }
         MultiFab::Copy(ph,p,0,0,ncomp,0);
         Lp.apply(amrlev, mglev, v, ph, MLLinOp::BCMode::Homogeneous);
         Lp.normalize(amrlev, mglev, v);
 
-        if ( Real rhTv = dotxy(rh,v) )
-	{
-            alpha = rho/rhTv;
-	}
-        else
-	{
-            ret = 2; break;
-	}
-        sxay(sol, sol,  alpha, ph);
-        sxay(s,     r, -alpha,  v);
+        dotxy(rh,v,rhTv.data());
+        for (int n = 0; n < ncomp; ++n) {
+            if ( !active[n] ) {
+                alpha[n] = 0.0;
+            } else if ( rhTv[n] ) {
+                alpha[n] = rho[n]/rhTv[n];
+            } else {
+                ret = 2;
+            }
+        }
+        if ( ret != 0 ) break;
+        sxay(sol, sol, alpha, ph);
+        sxay(s,     r, alpha,  v, -1.0);
 
-        rnorm = norm_inf(s);
+        norm_inf(s, rnorm.data());
 
         if ( verbose > 2 && ParallelDescriptor::IOProcessor(p.color()) )
         {
             std::cout << "MLCGSolver_BiCGStab: Half Iter "
                       << std::setw(11) << nit
                       << " rel. err. "
-                      << rnorm/(rnorm0) << '\n';
+                      << relerr(rnorm,rnorm0) << '\n';
         }
 
-        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        for (int n = 0; n < ncomp; ++n) {
+            if ( active[n] && converged(n) ) {
+                active[n] = false;
+                --nactive;
+            }
+        }
+        if ( nactive == 0 ) break;
 
         MultiFab::Copy(sh,s,0,0,ncomp,0);
         Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous);
@@ -169,26 +304,396 @@ MLCGSolver::solve (MultiFab&       sol,
         // in the following two dotxy()s.  We do that by calculating the "local"
         // values and then reducing the two local values at the same time.
         //
-        Real tvals[2] = { dotxy(t,t,true), dotxy(t,s,true) };
+        dotxy(t,t,tvals.data(),true);
+        dotxy(t,s,tvals.data()+ncomp,true);
 
-        ParallelAllReduce::Sum(tvals,2,Lp.BottomCommunicator());
+        ParallelAllReduce::Sum(tvals.data(),2*ncomp,Lp.BottomCommunicator());
 
-        if ( tvals[0] )
-	{
-            omega = tvals[1]/tvals[0];
-	}
+        for (int n = 0; n < ncomp; ++n) {
+            if ( !active[n] ) {
+                omega[n] = 0.0;
+            } else if ( tvals[n] ) {
+                omega[n] = tvals[ncomp+n]/tvals[n];
+            } else {
+                ret = 3;
+            }
+        }
+        if ( ret != 0 ) break;
+        sxay(sol, sol, omega, sh);
+        sxay(r,     s, omega,  t, -1.0);
+
+        norm_inf(r, rnorm.data());
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor(p.color()) )
+        {
+            std::cout << "MLCGSolver_BiCGStab: Iteration "
+                      << std::setw(11) << nit
+                      << " rel. err. "
+                      << relerr(rnorm,rnorm0) << '\n';
+        }
+
+        for (int n = 0; n < ncomp; ++n) {
+            if ( active[n] && converged(n) ) {
+                active[n] = false;
+                --nactive;
+            }
+        }
+        if ( nactive == 0 ) break;
+
+        for (int n = 0; n < ncomp; ++n) {
+            if ( active[n] && omega[n] == 0 ) ret = 4;
+        }
+        if ( ret != 0 ) break;
+        rho_1 = rho;
+    }
+
+    iter = std::min(nit, maxiter);
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+    {
+        std::cout << "MLCGSolver_BiCGStab: Final: Iteration "
+                  << std::setw(4) << nit
+                  << " rel. err. "
+                  << relerr(rnorm,rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && nactive > 0 )
+    {
+        if ( ParallelDescriptor::IOProcessor(p.color()) )
+            amrex::Warning("MLCGSolver_BiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        if ( !(( ret == 0 || ret == 8 ) && (rnorm[n] < rnorm0[n])) )
+        {
+            sol.setVal(0, n, 1);
+        }
+    }
+    sol.plus(sorig, 0, ncomp, 0);
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_cg (MultiFab&       sol,
+                      const MultiFab& rhs,
+                      Real            eps_rel,
+                      Real            eps_abs)
+{
+    BL_PROFILE_REGION("MLCGSolver::cg");
+
+    const int nghost = sol.nGrow(), ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+
+    MultiFab p(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory());
+    p.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab r    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab z    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab q    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,0);
+
+    sol.setVal(0);
+
+    // As in solve_bicgstab, the components are solved independently.
+    Vector<Real> rnorm(ncomp);
+    norm_inf(r, rnorm.data());
+    const Vector<Real> rnorm0 = rnorm;
+
+    Vector<int> active(ncomp);
+    int nactive = 0;
+    for (int n = 0; n < ncomp; ++n) {
+        active[n] = !(rnorm0[n] == 0 || rnorm0[n] < eps_abs);
+        nactive += active[n];
+    }
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+    {
+        std::cout << "MLCGSolver_CG: Initial error (error0) =        " << maxval(rnorm0) << '\n';
+    }
+
+    int ret = 0, nit = 1;
+    Vector<Real> rho(ncomp), rho_1(ncomp,0), alpha(ncomp), beta(ncomp), pw(ncomp);
+
+    iter = 0;
+
+    if ( nactive == 0 )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+        {
+            std::cout << "MLCGSolver_CG: niter = 0,"
+                      << ", rnorm = " << maxval(rnorm)
+                      << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    for (; nit <= maxiter; ++nit)
+    {
+        // Jacobi preconditioner
+        MultiFab::Copy(z,r,0,0,ncomp,0);
+        Lp.normalize(amrlev, mglev, z);
+
+        dotxy(z,r,rho.data());
+        for (int n = 0; n < ncomp; ++n) {
+            if ( active[n] && rho[n] == 0 ) ret = 1;
+        }
+        if ( ret != 0 ) break;
+        if ( nit == 1 )
+        {
+            MultiFab::Copy(p,z,0,0,ncomp,0);
+        }
         else
-	{
+        {
+            for (int n = 0; n < ncomp; ++n) {
+                beta[n] = active[n] ? rho[n]/rho_1[n] : 0.0;
+            }
+            sxay(p, z, beta, p);
+        }
+        Lp.apply(amrlev, mglev, q, p, MLLinOp::BCMode::Homogeneous);
+
+        dotxy(p,q,pw.data());
+        for (int n = 0; n < ncomp; ++n) {
+            if ( !active[n] ) {
+                alpha[n] = 0.0;
+            } else if ( pw[n] ) {
+                alpha[n] = rho[n]/pw[n];
+            } else {
+                ret = 2;
+            }
+        }
+        if ( ret != 0 ) break;
+
+        sxay(sol, sol, alpha, p);
+        sxay(r,     r, alpha, q, -1.0);
+
+        norm_inf(r, rnorm.data());
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor(p.color()) )
+        {
+            std::cout << "MLCGSolver_CG: Iteration "
+                      << std::setw(11) << nit
+                      << " rel. err. "
+                      << relerr(rnorm,rnorm0) << '\n';
+        }
+
+        for (int n = 0; n < ncomp; ++n) {
+            if ( active[n] && (rnorm[n] < eps_rel*rnorm0[n] || rnorm[n] < eps_abs) ) {
+                active[n] = false;
+                --nactive;
+            }
+        }
+        if ( nactive == 0 ) break;
+
+        rho_1 = rho;
+    }
+
+    iter = std::min(nit, maxiter);
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+    {
+        std::cout << "MLCGSolver_CG: Final: Iteration "
+                  << std::setw(4) << nit
+                  << " rel. err. "
+                  << relerr(rnorm,rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && nactive > 0 )
+    {
+        if ( ParallelDescriptor::IOProcessor(p.color()) )
+            amrex::Warning("MLCGSolver_CG:: failed to converge!");
+        ret = 8;
+    }
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        if ( !(( ret == 0 || ret == 8 ) && (rnorm[n] < rnorm0[n])) )
+        {
+            sol.setVal(0, n, 1);
+        }
+    }
+    sol.plus(sorig, 0, ncomp, 0);
+
+    return ret;
+}
+
+//
+// Pipelined BiCGStab, Algorithm 5 of Cools & Vanroose, "The communication-
+// hiding pipelined BiCGstab method for the parallel solution of large
+// unsymmetric linear systems", Parallel Computing 65 (2017).  Like the
+// classic version above it is left preconditioned with Lp.normalize.
+// The dot products of each half iteration and the inf-norm used for the
+// convergence test are reduced while the next operator apply is running.
+//
+int
+MLCGSolver::solve_pipe_bicgstab (MultiFab&       sol,
+                                 const MultiFab& rhs,
+                                 Real            eps_rel,
+                                 Real            eps_abs)
+{
+    BL_PROFILE_REGION("MLCGSolver::pipe_bicgstab");
+
+    const int nghost = sol.nGrow(), ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+
+    // These are the operands of Lp.apply.
+    MultiFab r(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory());
+    MultiFab w(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory());
+    MultiFab z(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory());
+    r.setVal(0.0);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab rh   (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab p    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab s    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab q    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab y    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab t    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab v    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+
+    MPI_Comm comm = Lp.BottomCommunicator();
+
+    auto op = [&] (MultiFab& out, MultiFab& in) {
+        Lp.apply(amrlev, mglev, out, in, MLLinOp::BCMode::Homogeneous);
+        Lp.normalize(amrlev, mglev, out);
+    };
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,0);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,0);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+    {
+        std::cout << "MLCGSolver_PipeBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+
+    int ret = 0, nit = 1;
+
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+        {
+            std::cout << "MLCGSolver_PipeBiCGStab: niter = 0,"
+                      << ", rnorm = " << rnorm
+                      << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    MPI_Request sum_req = MPI_REQUEST_NULL, max_req = MPI_REQUEST_NULL;
+    Real vals[4];
+
+    op(w, r);
+
+    vals[0] = dotxy(rh,r,true);
+    vals[1] = dotxy(rh,w,true);
+    ParallelAllReduce::ISum(vals, 2, comm, sum_req);
+    op(t, w);
+    ParallelAllReduce::Wait(sum_req);
+
+    Real rho = vals[0], alpha = 0, beta = 0, omega = 0;
+    if ( vals[1] )
+    {
+        alpha = rho/vals[1];
+    }
+    else
+    {
+        ret = 2;
+    }
+
+    for (; ret == 0 && nit <= maxiter; ++nit)
+    {
+        if ( nit == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,0);
+            MultiFab::Copy(s,w,0,0,ncomp,0);
+            MultiFab::Copy(z,t,0,0,ncomp,0);
+        }
+        else
+        {
+            sxay(p, p, -omega, s);
+            sxay(p, r,   beta, p);
+            sxay(s, s, -omega, z);
+            sxay(s, w,   beta, s);
+            sxay(z, z, -omega, v);
+            sxay(z, t,   beta, z);
+        }
+        sxay(q, r, -alpha, s);
+        sxay(y, w, -alpha, z);
+
+        vals[0] = dotxy(q,y,true);
+        vals[1] = dotxy(y,y,true);
+        rnorm = norm_inf(q,true);
+        ParallelAllReduce::ISum(vals, 2, comm, sum_req);
+        ParallelAllReduce::IMax(&rnorm, 1, comm, max_req);
+        op(v, z);
+        ParallelAllReduce::Wait(sum_req);
+        ParallelAllReduce::Wait(max_req);
+
+        if ( verbose > 2 && ParallelDescriptor::IOProcessor(p.color()) )
+        {
+            std::cout << "MLCGSolver_PipeBiCGStab: Half Iter "
+                      << std::setw(11) << nit
+                      << " rel. err. "
+                      << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+        {
+            sxay(sol, sol, alpha, p);
+            break;
+        }
+
+        if ( vals[1] )
+        {
+            omega = vals[0]/vals[1];
+        }
+        else
+        {
             ret = 3; break;
-	}
-        sxay(sol, sol,  omega, sh);
-        sxay(r,     s, -omega,  t);
+        }
 
-        rnorm = norm_inf(r);
+        sxay(sol, sol, alpha, p);
+        sxay(sol, sol, omega, q);
+        sxay(r, q, -omega, y);
+        sxay(t, t, -alpha, v);
+        sxay(w, y, -omega, t);
+
+        vals[0] = dotxy(rh,r,true);
+        vals[1] = dotxy(rh,w,true);
+        vals[2] = dotxy(rh,s,true);
+        vals[3] = dotxy(rh,z,true);
+        rnorm = norm_inf(r,true);
+        ParallelAllReduce::ISum(vals, 4, comm, sum_req);
+        ParallelAllReduce::IMax(&rnorm, 1, comm, max_req);
+        op(t, w);
+        ParallelAllReduce::Wait(sum_req);
+        ParallelAllReduce::Wait(max_req);
 
         if ( verbose > 2 && ParallelDescriptor::IOProcessor(p.color()) )
         {
-            std::cout << "MLCGSolver_BiCGStab: Iteration "
+            std::cout << "MLCGSolver_PipeBiCGStab: Iteration "
                       << std::setw(11) << nit
                       << " rel. err. "
                       << rnorm/(rnorm0) << '\n';
@@ -197,15 +702,33 @@ MLCGSolver::solve (MultiFab&       sol,
         if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
 
         if ( omega == 0 )
-	{
+        {
             ret = 4; break;
-	}
-        rho_1 = rho;
+        }
+        if ( vals[0] == 0 )
+        {
+            ret = 1; break;
+        }
+
+        beta = (alpha/omega)*(vals[0]/rho);
+        rho = vals[0];
+
+        const Real denom = vals[1] + beta*vals[2] - beta*omega*vals[3];
+        if ( denom )
+        {
+            alpha = rho/denom;
+        }
+        else
+        {
+            ret = 2; break;
+        }
     }
 
+    iter = std::min(nit, maxiter);
+
     if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
     {
-        std::cout << "MLCGSolver_BiCGStab: Final: Iteration "
+        std::cout << "MLCGSolver_PipeBiCGStab: Final: Iteration "
                   << std::setw(4) << nit
                   << " rel. err. "
                   << rnorm/(rnorm0) << '\n';
@@ -214,15 +737,428 @@ MLCGSolver::solve (MultiFab&       sol,
     if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
     {
         if ( ParallelDescriptor::IOProcessor(p.color()) )
-            amrex::Warning("MLCGSolver_BiCGStab:: failed to converge!");
+            amrex::Warning("MLCGSolver_PipeBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+
+    return ret;
+}
+
+//
+// Pipelined preconditioned CG, Algorithm 4 of Ghysels & Vanroose, "Hiding
+// global synchronization latency in the preconditioned Conjugate Gradient
+// algorithm", Parallel Computing 40 (2014), with Lp.normalize as the
+// (Jacobi) preconditioner.  The two dot products and the inf-norm of the
+// residual are reduced while the preconditioner and the operator are
+// applied to w.
+//
+int
+MLCGSolver::solve_pipe_cg (MultiFab&       sol,
+                           const MultiFab& rhs,
+                           Real            eps_rel,
+                           Real            eps_abs)
+{
+    BL_PROFILE_REGION("MLCGSolver::pipe_cg");
+
+    const int nghost = sol.nGrow(), ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+
+    // These are the operands of Lp.apply.
+    MultiFab u(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory());
+    MultiFab m(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory());
+    u.setVal(0.0);
+    m.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab r    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab w    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab n    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab z    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab q    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab s    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab p    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+
+    MPI_Comm comm = Lp.BottomCommunicator();
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,0);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+    {
+        std::cout << "MLCGSolver_PipeCG: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+
+    int ret = 0, nit = 1;
+
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+        {
+            std::cout << "MLCGSolver_PipeCG: niter = 0,"
+                      << ", rnorm = " << rnorm
+                      << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    MultiFab::Copy(u,r,0,0,ncomp,0);
+    Lp.normalize(amrlev, mglev, u);
+    Lp.apply(amrlev, mglev, w, u, MLLinOp::BCMode::Homogeneous);
+
+    MPI_Request sum_req = MPI_REQUEST_NULL, max_req = MPI_REQUEST_NULL;
+    Real vals[2];
+    Real gamma_1 = 0, alpha_1 = 0;
+    bool converged = false;
+
+    for (; nit <= maxiter; ++nit)
+    {
+        vals[0] = dotxy(r,u,true);
+        vals[1] = dotxy(w,u,true);
+        ParallelAllReduce::ISum(vals, 2, comm, sum_req);
+        if ( nit > 1 )
+        {
+            rnorm = norm_inf(r,true);
+            ParallelAllReduce::IMax(&rnorm, 1, comm, max_req);
+        }
+
+        MultiFab::Copy(m,w,0,0,ncomp,0);
+        Lp.normalize(amrlev, mglev, m);
+        Lp.apply(amrlev, mglev, n, m, MLLinOp::BCMode::Homogeneous);
+
+        ParallelAllReduce::Wait(sum_req);
+
+        if ( nit > 1 )
+        {
+            ParallelAllReduce::Wait(max_req);
+
+            if ( verbose > 2 && ParallelDescriptor::IOProcessor(p.color()) )
+            {
+                std::cout << "MLCGSolver_PipeCG: Iteration "
+                          << std::setw(11) << nit-1
+                          << " rel. err. "
+                          << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                converged = true; break;
+            }
+        }
+
+        const Real gamma = vals[0], delta = vals[1];
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real alpha, beta;
+        if ( nit == 1 )
+        {
+            beta  = 0;
+            alpha = delta ? gamma/delta : 0;
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            const Real denom = delta - beta*gamma/alpha_1;
+            alpha = denom ? gamma/denom : 0;
+        }
+        if ( alpha == 0 )
+        {
+            ret = 2; break;
+        }
+
+        if ( nit == 1 )
+        {
+            MultiFab::Copy(z,n,0,0,ncomp,0);
+            MultiFab::Copy(q,m,0,0,ncomp,0);
+            MultiFab::Copy(s,w,0,0,ncomp,0);
+            MultiFab::Copy(p,u,0,0,ncomp,0);
+        }
+        else
+        {
+            sxay(z, n, beta, z);
+            sxay(q, m, beta, q);
+            sxay(s, w, beta, s);
+            sxay(p, u, beta, p);
+        }
+
+        sxay(sol, sol,  alpha, p);
+        sxay(r,     r, -alpha, s);
+        sxay(u,     u, -alpha, q);
+        sxay(w,     w, -alpha, z);
+
+        gamma_1 = gamma;
+        alpha_1 = alpha;
+    }
+
+    if ( converged )
+    {
+        --nit;
+    }
+    else if ( ret == 0 )
+    {
+        rnorm = norm_inf(r);
+    }
+
+    iter = std::min(nit, maxiter);
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(p.color()) )
+    {
+        std::cout << "MLCGSolver_PipeCG: Final: Iteration "
+                  << std::setw(4) << nit
+                  << " rel. err. "
+                  << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( ParallelDescriptor::IOProcessor(p.color()) )
+            amrex::Warning("MLCGSolver_PipeCG:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, 0);
+    }
+
+    return ret;
+}
+
+//
+// s-step preconditioned CG (Chronopoulos & Gear, "s-step iterative methods
+// for symmetric linear systems", J. Comput. Appl. Math. 25 (1989)).  Each
+// outer iteration builds the monomial basis V = [u, Mu, ..., M^(s-1)u] with
+// M = normalize(A) and u = normalize(r), makes it A-conjugate to the
+// previous block and then takes s CG steps at once.  All the inner products
+// of an outer iteration, (AP_old,V), (V,AV) and (V,r), go into a single
+// allreduce; the inf-norm of r is reduced while the basis is being built.
+//
+int
+MLCGSolver::solve_sstep_cg (MultiFab&       sol,
+                            const MultiFab& rhs,
+                            Real            eps_rel,
+                            Real            eps_abs)
+{
+    BL_PROFILE_REGION("MLCGSolver::sstep_cg");
+
+    const int nghost = sol.nGrow(), ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+
+    const int ss = sstep;
+
+    // V holds the basis and, after conjugation, the new search directions;
+    // P holds the search directions of the previous outer iteration.
+    Vector<std::unique_ptr<MultiFab> > V(ss), AV(ss), P(ss), AP(ss);
+    for (int j = 0; j < ss; ++j)
+    {
+        V [j].reset(new MultiFab(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory()));
+        P [j].reset(new MultiFab(ba, dm, ncomp, nghost, MFInfo(), FArrayBoxFactory()));
+        AV[j].reset(new MultiFab(ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory()));
+        AP[j].reset(new MultiFab(ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory()));
+        V[j]->setVal(0.0);
+        P[j]->setVal(0.0);
+    }
+
+    MultiFab sorig(ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+    MultiFab r    (ba, dm, ncomp, 0, MFInfo(), FArrayBoxFactory());
+
+    MPI_Comm comm = Lp.BottomCommunicator();
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,0);
+
+    sol.setVal(0);
+
+    Real rnorm = norm_inf(r);
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(r.color()) )
+    {
+        std::cout << "MLCGSolver_SStepCG: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+
+    int ret = 0, nit = 0;
+
+    iter = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor(r.color()) )
+        {
+            std::cout << "MLCGSolver_SStepCG: niter = 0,"
+                      << ", rnorm = " << rnorm
+                      << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    // Row-major s x s matrices.  Gram holds C = (AP_old,V), G = (V,AV) and
+    // g = (V,r), in that order.
+    const int s2 = ss*ss;
+    Vector<Real> Gram(2*s2+ss), W(s2), Wold(s2), B(s2), a(ss);
+    Real* C = Gram.data();
+    Real* G = Gram.data() + s2;
+    Real* g = Gram.data() + 2*s2;
+
+    MPI_Request max_req = MPI_REQUEST_NULL;
+    bool converged = false;
+
+    for (int k = 0; nit < maxiter; ++k)
+    {
+        if ( k > 0 )
+        {
+            rnorm = norm_inf(r,true);
+            ParallelAllReduce::IMax(&rnorm, 1, comm, max_req);
+        }
+
+        MultiFab::Copy(*V[0],r,0,0,ncomp,0);
+        Lp.normalize(amrlev, mglev, *V[0]);
+        for (int j = 0; j < ss; ++j)
+        {
+            Lp.apply(amrlev, mglev, *AV[j], *V[j], MLLinOp::BCMode::Homogeneous);
+            if ( j+1 < ss )
+            {
+                MultiFab::Copy(*V[j+1],*AV[j],0,0,ncomp,0);
+                Lp.normalize(amrlev, mglev, *V[j+1]);
+            }
+        }
+
+        if ( k > 0 )
+        {
+            ParallelAllReduce::Wait(max_req);
+
+            if ( verbose > 2 && ParallelDescriptor::IOProcessor(r.color()) )
+            {
+                std::cout << "MLCGSolver_SStepCG: Iteration "
+                          << std::setw(11) << nit
+                          << " rel. err. "
+                          << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+            {
+                converged = true; break;
+            }
+        }
+
+        for (int i = 0; i < ss; ++i)
+        {
+            for (int j = 0; j < ss; ++j)
+            {
+                C[i*ss+j] = (k > 0) ? dotxy(*AP[i],*V[j],true) : 0.0;
+                G[i*ss+j] = dotxy(*V[i],*AV[j],true);
+            }
+            g[i] = dotxy(*V[i],r,true);
+        }
+        ParallelAllReduce::Sum(Gram.data(), Gram.size(), comm);
+
+        W.assign(G, G+s2);
+        if ( k > 0 )
+        {
+            // B = -Wold^{-1} C, and then P = V + P_old B, W = G + C^T B.
+            B.assign(C, C+s2);
+            if ( !dense_solve(ss, Wold, B.data(), ss) )
+            {
+                ret = 2; break;
+            }
+            for (auto& b : B) b = -b;
+
+            for (int j = 0; j < ss; ++j)
+            {
+                for (int i = 0; i < ss; ++i)
+                {
+                    sxay(*V [j], *V [j], B[i*ss+j], *P [i]);
+                    sxay(*AV[j], *AV[j], B[i*ss+j], *AP[i]);
+                }
+            }
+            for (int i = 0; i < ss; ++i)
+            {
+                for (int j = 0; j < ss; ++j)
+                {
+                    for (int l = 0; l < ss; ++l)
+                    {
+                        W[i*ss+j] += C[l*ss+i]*B[l*ss+j];
+                    }
+                }
+            }
+        }
+
+        Wold = W;
+        a.assign(g, g+ss);
+        if ( !dense_solve(ss, W, a.data(), 1) )
+        {
+            ret = 1; break;
+        }
+
+        for (int j = 0; j < ss; ++j)
+        {
+            sxay(sol, sol,  a[j], *V [j]);
+            sxay(r,     r, -a[j], *AV[j]);
+        }
+
+        std::swap(V, P);
+        std::swap(AV, AP);
+
+        nit += ss;
+    }
+
+    if ( !converged && ret == 0 )
+    {
+        rnorm = norm_inf(r);
+    }
+
+    iter = nit;
+
+    if ( verbose > 0 && ParallelDescriptor::IOProcessor(r.color()) )
+    {
+        std::cout << "MLCGSolver_SStepCG: Final: Iteration "
+                  << std::setw(4) << nit
+                  << " rel. err. "
+                  << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( ParallelDescriptor::IOProcessor(r.color()) )
+            amrex::Warning("MLCGSolver_SStepCG:: failed to converge!");
         ret = 8;
     }
 
     if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
     {
         sol.plus(sorig, 0, ncomp, 0);
-    } 
-    else 
+    }
+    else
     {
         sol.setVal(0);
         sol.plus(sorig, 0, ncomp, 0);
@@ -237,6 +1173,34 @@ MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
     return Lp.xdoty(amrlev, mglev, r, z, local);
 }
 
+void
+MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, Real* result, bool local)
+{
+    const int ncomp = r.nComp();
+    if (ncomp == 1) {
+        result[0] = Lp.xdoty(amrlev, mglev, r, z, local);
+        return;
+    }
+    for (int n = 0; n < ncomp; ++n) {
+        result[n] = MultiFab::Dot(r, n, z, n, 1, 0, true);
+    }
+    if (!local) {
+        ParallelAllReduce::Sum(result, ncomp, Lp.BottomCommunicator());
+    }
+}
+
+void
+MLCGSolver::norm_inf (const MultiFab& res, Real* result, bool local)
+{
+    const int ncomp = res.nComp();
+    for (int n = 0; n < ncomp; ++n) {
+        result[n] = res.norm0(n,0,true);
+    }
+    if (!local) {
+        ParallelAllReduce::Max(result, ncomp, Lp.BottomCommunicator());
+    }
+}
+
 Real
 MLCGSolver::norm_inf (const MultiFab& res, bool local)
 {
@@ -3,6 +3,7 @@
 #include <AMReX_MLLinOp_F.H>
 #include <AMReX_MG_F.H>
 #include <AMReX_MultiFabUtil.H>
+#include <AMReX_BoxIterator.H>
 
 namespace amrex {
 
@@ -337,12 +338,225 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
-    for (int redblack = 0; redblack < 2; ++redblack)
+    if (m_smoother == Smoother::l1jacobi)
+    {
+        smoothJacobi(amrlev, mglev, sol, rhs, skip_fillboundary);
+    }
+    else if (m_smoother == Smoother::chebyshev)
+    {
+        smoothChebyshev(amrlev, mglev, sol, rhs, skip_fillboundary);
+    }
+    else
+    {
+        for (int redblack = 0; redblack < 2; ++redblack)
+        {
+            applyBC(amrlev, mglev, sol, BCMode::Homogeneous, nullptr, skip_fillboundary);
+            Fsmooth(amrlev, mglev, sol, rhs, redblack);
+            skip_fillboundary = false;
+        }
+    }
+}
+
+void
+MLCellLinOp::smoothJacobi (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                           bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::smoothJacobi()");
+
+    const int ncomp = getNComp();
+    const MultiFab& dinv = smootherDiagInv(amrlev, mglev);
+    MultiFab ax(sol.boxArray(), sol.DistributionMap(), ncomp, 0);
+
+    for (int k = 0; k < m_smoother_degree; ++k)
     {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous, nullptr, skip_fillboundary);
-        Fsmooth(amrlev, mglev, sol, rhs, redblack);
         skip_fillboundary = false;
+        Fapply(amrlev, mglev, ax, sol);
+
+        // sol += D_l1^{-1} (rhs - L(sol))
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(sol, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            amrex_mllinop_jacobi(BL_TO_FORTRAN_BOX(bx),
+                                 BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                 BL_TO_FORTRAN_ANYD(ax[mfi]),
+                                 BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                 BL_TO_FORTRAN_ANYD(dinv[mfi]),
+                                 ncomp);
+        }
+    }
+}
+
+void
+MLCellLinOp::smoothChebyshev (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::smoothChebyshev()");
+
+    const int ncomp = getNComp();
+    const MultiFab& dinv = smootherDiagInv(amrlev, mglev);
+    const Real lambda = smootherMaxEigen(amrlev, mglev);
+
+    // Chebyshev iteration on [eig_lo, eig_hi] (Saad, Algorithm 12.1)
+    const Real eig_hi = 1.1*lambda;
+    const Real eig_lo = 0.3*lambda;
+    const Real theta = 0.5*(eig_hi+eig_lo);
+    const Real delta = 0.5*(eig_hi-eig_lo);
+    const Real sigma = theta/delta;
+    Real rho = 1.0/sigma;
+
+    MultiFab ax(sol.boxArray(), sol.DistributionMap(), ncomp, 0);
+    MultiFab d (sol.boxArray(), sol.DistributionMap(), ncomp, 0);
+
+    for (int k = 0; k < m_smoother_degree; ++k)
+    {
+        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, nullptr, skip_fillboundary);
+        skip_fillboundary = false;
+        Fapply(amrlev, mglev, ax, sol);
+
+        // d = c1*d + c2*D^{-1} (rhs - L(sol)); sol += d
+        Real c1, c2;
+        if (k == 0) {
+            c1 = 0.0;
+            c2 = 1.0/theta;
+        } else {
+            const Real rho_new = 1.0/(2.0*sigma - rho);
+            c1 = rho_new*rho;
+            c2 = 2.0*rho_new/delta;
+            rho = rho_new;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(sol, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            amrex_mllinop_chebyshev(BL_TO_FORTRAN_BOX(bx),
+                                    BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                    BL_TO_FORTRAN_ANYD(d[mfi]),
+                                    BL_TO_FORTRAN_ANYD(ax[mfi]),
+                                    BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                    BL_TO_FORTRAN_ANYD(dinv[mfi]),
+                                    c1, c2, ncomp);
+        }
+    }
+}
+
+const MultiFab&
+MLCellLinOp::smootherDiagInv (int amrlev, int mglev) const
+{
+    const bool l1 = (m_smoother == Smoother::l1jacobi);
+    if (m_smoother_dinv.empty() || l1 != m_smoother_dinv_l1)
+    {
+        m_smoother_dinv.clear();
+        m_smoother_dinv.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_smoother_dinv[alev].resize(m_num_mg_levels[alev]);
+        }
+        m_smoother_eigen.clear();
+        m_smoother_dinv_l1 = l1;
+    }
+
+    std::unique_ptr<MultiFab>& p = m_smoother_dinv[amrlev][mglev];
+    if (p == nullptr)
+    {
+        BL_PROFILE("MLCellLinOp::smootherDiagInv()");
+
+        const int ncomp = getNComp();
+        const BoxArray& ba = m_grids[amrlev][mglev];
+        const DistributionMapping& dm = m_dmap[amrlev][mglev];
+
+        p.reset(new MultiFab(ba, dm, ncomp, 0));
+        MultiFab& dinv = *p;
+        dinv.setVal(1.0);
+        normalize(amrlev, mglev, dinv);
+
+        if (l1)
+        {
+            // The off-diagonal entries of the cell-centered operators are
+            // non-positive, so L applied to ones, ghost cells included,
+            // is the diagonal minus the l1 norm of the off-diagonal part.
+            // Hence D_l1 = 2 D - L(1).
+            MultiFab ones(ba, dm, ncomp, 1);
+            ones.setVal(1.0);
+            MultiFab dl1(ba, dm, ncomp, 0);
+            Fapply(amrlev, mglev, dl1, ones);
+            dl1.mult(-1.0, 0, ncomp);
+            MultiFab two_d(ba, dm, ncomp, 0);
+            two_d.setVal(2.0);
+            MultiFab::Divide(two_d, dinv, 0, 0, ncomp, 0);
+            MultiFab::Add(dl1, two_d, 0, 0, ncomp, 0);
+            dinv.setVal(1.0);
+            MultiFab::Divide(dinv, dl1, 0, 0, ncomp, 0);
+        }
     }
+    return *p;
+}
+
+Real
+MLCellLinOp::smootherMaxEigen (int amrlev, int mglev) const
+{
+    const MultiFab& dinv = smootherDiagInv(amrlev, mglev);
+
+    if (m_smoother_eigen.empty())
+    {
+        m_smoother_eigen.resize(m_num_amr_levels);
+        for (int alev = 0; alev < m_num_amr_levels; ++alev) {
+            m_smoother_eigen[alev].resize(m_num_mg_levels[alev], -1.0);
+        }
+    }
+
+    Real& lambda = m_smoother_eigen[amrlev][mglev];
+    if (lambda < 0.0)
+    {
+        BL_PROFILE("MLCellLinOp::smootherMaxEigen()");
+
+        const int ncomp = getNComp();
+        const BoxArray& ba = m_grids[amrlev][mglev];
+        const DistributionMapping& dm = m_dmap[amrlev][mglev];
+
+        // Power iteration on D^{-1} L, starting from a checkerboard,
+        // which is close to the highest mode.
+        MultiFab v(ba, dm, ncomp, 1);
+        MultiFab w(ba, dm, ncomp, 0);
+        v.setVal(0.0);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(v, true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            FArrayBox& vfab = v[mfi];
+            for (BoxIterator bit(bx); bit.ok(); ++bit)
+            {
+                const IntVect& iv = bit();
+                const Real s = ((AMREX_D_TERM(iv[0],+iv[1],+iv[2])) & 1) ? -1.0 : 1.0;
+                for (int n = 0; n < ncomp; ++n) {
+                    vfab(iv,n) = s;
+                }
+            }
+        }
+
+        Real vnorm = std::sqrt(xdoty(amrlev, mglev, v, v, false));
+        lambda = 0.0;
+        for (int it = 0; it < 10; ++it)
+        {
+            applyBC(amrlev, mglev, v, BCMode::Homogeneous, nullptr);
+            Fapply(amrlev, mglev, w, v);
+            MultiFab::Multiply(w, dinv, 0, 0, ncomp, 0);
+            const Real wnorm = std::sqrt(xdoty(amrlev, mglev, w, w, false));
+            if (wnorm == 0.0) break;
+            lambda = wnorm/vnorm;
+            MultiFab::Copy(v, w, 0, 0, ncomp, 0);
+            v.mult(1.0/wnorm, 0, ncomp);
+            vnorm = 1.0;
+        }
+    }
+    return lambda;
 }
 
 void
@@ -418,6 +632,35 @@ MLCellLinOp::correctionResidual (int amrlev, int mglev, MultiFab& resid, MultiFa
     MultiFab::Xpay(resid, -1.0, b, 0, 0, ncomp, 0);
 }
 
+void
+MLCellLinOp::correctionResidualRestriction (int amrlev, int cmglev, MultiFab& crse_res,
+                                            MultiFab& x, const MultiFab& b, MultiFab& fine_res)
+{
+    if (!hasFusedResRestriction()) {
+        MLLinOp::correctionResidualRestriction(amrlev, cmglev, crse_res, x, b, fine_res);
+        return;
+    }
+
+    BL_PROFILE("MLCellLinOp::correctionResidualRestriction()");
+
+    const int mglev = cmglev-1;
+    applyBC(amrlev, mglev, x, BCMode::Homogeneous, nullptr);
+
+    // With agglomeration or consolidation the coarse MG grids are not
+    // simply the coarsened fine grids.
+    const BoxArray& cba = amrex::coarsen(x.boxArray(), 2);
+    if (cba == crse_res.boxArray() && x.DistributionMap() == crse_res.DistributionMap())
+    {
+        FresRestriction(amrlev, mglev, crse_res, x, b);
+    }
+    else
+    {
+        MultiFab tmp(cba, x.DistributionMap(), crse_res.nComp(), 0);
+        FresRestriction(amrlev, mglev, tmp, x, b);
+        crse_res.copy(tmp);
+    }
+}
+
 void
 MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode,
                       const MLMGBndry* bndry, bool skip_fillboundary) const
@@ -606,6 +849,9 @@ MLCellLinOp::prepareForSolve ()
 {
     BL_PROFILE("MLCellLinOp::prepareForSolve()");
 
+    m_smoother_dinv.clear();
+    m_smoother_eigen.clear();
+
     const int ncomp = getNComp();
     for (int amrlev = 0;  amrlev < m_num_amr_levels; ++amrlev)
     {
@@ -296,12 +296,21 @@ MLLinOp::make (Vector<Vector<MultiFab> >& mf, int nc, int ng) const
     }
 }
 
+void
+MLLinOp::correctionResidualRestriction (int amrlev, int cmglev, MultiFab& crse_res,
+                                        MultiFab& x, const MultiFab& b, MultiFab& fine_res)
+{
+    correctionResidual(amrlev, cmglev-1, fine_res, x, b, BCMode::Homogeneous);
+    restriction(amrlev, cmglev, crse_res, fine_res);
+}
+
 void
 MLLinOp::setDomainBC (const std::array<BCType,AMREX_SPACEDIM>& a_lobc,
                       const std::array<BCType,AMREX_SPACEDIM>& a_hibc)
 {
     m_lobc = a_lobc;
     m_hibc = a_hibc;
+    m_needs_update = true;
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         if (Geometry::isPeriodic(idim)) {
             AMREX_ALWAYS_ASSERT(m_lobc[idim] == BCType::Periodic);
@@ -321,6 +330,26 @@ MLLinOp::setCoarseFineBC (const MultiFab* crse, int crse_ratio)
     m_coarse_data_crse_ratio = crse_ratio;
 }
 
+bool
+MLLinOp::rebind (const Vector<BoxArray>& a_grids,
+                 const Vector<DistributionMapping>& a_dmap)
+{
+    BL_PROFILE("MLLinOp::rebind()");
+
+    if (int(a_grids.size()) != m_num_amr_levels || int(a_dmap.size()) != m_num_amr_levels) {
+        return false;
+    }
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        if (a_grids[amrlev] != m_grids[amrlev][0] || a_dmap[amrlev] != m_dmap[amrlev][0]) {
+            return false;
+        }
+    }
+
+    m_needs_update = true;
+    return true;
+}
+
 MPI_Comm
 MLLinOp::makeSubCommunicator (const DistributionMapping& dm)
 {
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 #include <AMReX_MLMG.H>
 #include <AMReX_MultiFabUtil.H>
@@ -48,39 +51,70 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     Real solve_start_time = amrex::second();
 
-    Real composite_norminf;
-
     prepareForSolve(a_sol, a_rhs);
+    amg_coeffs_current = false;
 
     computeMLResidual(finest_amr_lev);
 
     int ncomp = linop.getNComp();
 
+    // With ncomp > 1 every component is a separate right-hand side with its
+    // own target, and the solve is converged once all of them are.
     bool local = true;
-    Real resnorm0 = MLResNormInf(finest_amr_lev, local); 
-    Real rhsnorm0 = MLRhsNormInf(local); 
+    Vector<Real> resnorm0 = MLResNormInf(finest_amr_lev, local);
+    Vector<Real> rhsnorm0 = MLRhsNormInf(local);
     if (!is_nsolve) {
-        ParallelDescriptor::ReduceRealMax({resnorm0, rhsnorm0}, rhs[0].color());
+        resnorm0.insert(resnorm0.end(), rhsnorm0.begin(), rhsnorm0.end());
+        ParallelDescriptor::ReduceRealMax(resnorm0.data(), 2*ncomp, rhs[0].color());
+        rhsnorm0.assign(resnorm0.begin()+ncomp, resnorm0.end());
+        resnorm0.resize(ncomp);
 
         if (verbose >= 1)
         {
-            amrex::Print() << "MLMG: Initial rhs               = " << rhsnorm0 << "\n"
-                           << "MLMG: Initial residual (resid0) = " << resnorm0 << "\n";
+            amrex::Print() << "MLMG: Initial rhs               =";
+            for (int n = 0; n < ncomp; ++n) amrex::Print() << " " << rhsnorm0[n];
+            amrex::Print() << "\n" << "MLMG: Initial residual (resid0) =";
+            for (int n = 0; n < ncomp; ++n) amrex::Print() << " " << resnorm0[n];
+            amrex::Print() << "\n";
         }
     }
 
-    Real max_norm;
-    std::string norm_name;
-    if (always_use_bnorm or rhsnorm0 >= resnorm0) {
-        norm_name = "bnorm";
-        max_norm = rhsnorm0;
-    } else {
-        norm_name = "resid0";
-        max_norm = resnorm0;
+    Vector<Real> max_norm(ncomp);
+    Vector<Real> res_target(ncomp);
+    int nbnorm = 0;
+    for (int n = 0; n < ncomp; ++n)
+    {
+        if (always_use_bnorm or rhsnorm0[n] >= resnorm0[n]) {
+            ++nbnorm;
+            max_norm[n] = rhsnorm0[n];
+        } else {
+            max_norm[n] = resnorm0[n];
+        }
+        res_target[n] = std::max(a_tol_abs, std::max(a_tol_rel,1.e-13)*max_norm[n]);
     }
-    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,1.e-13)*max_norm);
+    const std::string norm_name = (nbnorm == ncomp) ? "bnorm"
+                                : ((nbnorm == 0) ? "resid0" : "max(bnorm,resid0)");
+
+    // Whether every component of norm is within its target, and the
+    // relative norms for printing.
+    auto all_converged = [&] (const Vector<Real>& norm) -> bool {
+        for (int n = 0; n < ncomp; ++n) {
+            if (norm[n] > res_target[n]) return false;
+        }
+        return true;
+    };
+    auto relnorm = [&] (const Vector<Real>& norm) -> std::string {
+        std::ostringstream ss;
+        ss << std::setprecision(6);
+        for (int n = 0; n < ncomp; ++n) {
+            ss << (n > 0 ? " " : "") << norm[n]/max_norm[n];
+        }
+        return ss.str();
+    };
+
+    Vector<Real> composite_norminf;
 
-    if (!is_nsolve && resnorm0 <= res_target)
+    if (!is_nsolve && all_converged(resnorm0))
     {
         composite_norminf = resnorm0;
         if (verbose >= 1) {
@@ -93,45 +127,69 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         bool converged = false;
 
         const int niters = do_fixed_number_of_iters ? do_fixed_number_of_iters : max_iters;
+        if (krylov != Krylov::none) krylovSetup();
+
         for (int iter = 0; iter < niters; ++iter)
         {
-            oneIter(iter);
-
             converged = false;
 
-            // Test convergence on the fine amr level
-            computeResidual(finest_amr_lev);
-
-            if (is_nsolve) continue;
-
-            Real fine_norminf = ResNormInf(finest_amr_lev);
-            composite_norminf = fine_norminf;
-            if (verbose >= 2) {
-                amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
-                               << norm_name << " = " << fine_norminf/max_norm << "\n";
-            }
-            bool fine_converged = (fine_norminf <= res_target);
-
-            if (namrlevs == 1 and fine_converged)
+            if (krylov != Krylov::none)
             {
-                converged = true;
-            }
-            else if (fine_converged)
-            {
-                // finest level is converged, but we still need to test the coarse levels
-                computeMLResidual(finest_amr_lev-1);
-                Real crse_norminf = MLResNormInf(finest_amr_lev-1);
+                if (krylov == Krylov::fcg) {
+                    krylovFCGIter(iter);
+                } else {
+                    krylovFGMRESIter(iter);
+                }
+
+                // res holds the composite residual on every level.
+                composite_norminf = MLResNormInf(finest_amr_lev);
                 if (verbose >= 2) {
                     amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1
-                                   << " Crse resid/" << norm_name << " = "
-                                   << crse_norminf/max_norm << "\n";
+                                   << " Composite resid/" << norm_name << " = "
+                                   << relnorm(composite_norminf) << "\n";
                 }
-                converged = (crse_norminf <= res_target);
-                composite_norminf = std::max(fine_norminf, crse_norminf);
+                converged = all_converged(composite_norminf);
             }
             else
             {
-                converged = false;
+                oneIter(iter);
+
+                // Test convergence on the fine amr level
+                computeResidual(finest_amr_lev);
+
+                if (is_nsolve) continue;
+
+                Vector<Real> fine_norminf = ResNormInf(finest_amr_lev);
+                composite_norminf = fine_norminf;
+                if (verbose >= 2) {
+                    amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
+                                   << norm_name << " = " << relnorm(fine_norminf) << "\n";
+                }
+                bool fine_converged = all_converged(fine_norminf);
+
+                if (namrlevs == 1 and fine_converged)
+                {
+                    converged = true;
+                }
+                else if (fine_converged)
+                {
+                    // finest level is converged, but we still need to test the coarse levels
+                    computeMLResidual(finest_amr_lev-1);
+                    Vector<Real> crse_norminf = MLResNormInf(finest_amr_lev-1);
+                    if (verbose >= 2) {
+                        amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1
+                                       << " Crse resid/" << norm_name << " = "
+                                       << relnorm(crse_norminf) << "\n";
+                    }
+                    converged = all_converged(crse_norminf);
+                    for (int n = 0; n < ncomp; ++n) {
+                        composite_norminf[n] = std::max(fine_norminf[n], crse_norminf[n]);
+                    }
+                }
+                else
+                {
+                    converged = false;
+                }
             }
 
             if (converged)
@@ -139,8 +197,9 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
                 if (verbose >= 1) {
                     amrex::Print() << "MLMG: Final Iter. " << iter+1
                                    << " resid, resid/" << norm_name << " = "
-                                   << composite_norminf << ", "
-                                   << composite_norminf/max_norm << "\n";
+                                   << *std::max_element(composite_norminf.begin(),
+                                                        composite_norminf.end())
+                                   << ", " << relnorm(composite_norminf) << "\n";
                 }
                 break;
             }
@@ -148,8 +207,9 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         if (!converged && do_fixed_number_of_iters == 0) {
             amrex::Print() << "MLMG: Failed to converge after " << max_iters << " iterations."
                            << " resid, resid/" << norm_name << " = "
-                           << composite_norminf << ", "
-                           << composite_norminf/max_norm << "\n";
+                           << *std::max_element(composite_norminf.begin(),
+                                                composite_norminf.end())
+                           << ", " << relnorm(composite_norminf) << "\n";
             amrex::Abort("MLMG failed");
         }
         timer[iter_time] = amrex::second() - iter_start_time;
@@ -168,11 +228,13 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     if (verbose >= 1) {
         ParallelDescriptor::ReduceRealMax(timer.data(), timer.size());
         amrex::Print() << "MLMG: Timers: Solve = " << timer[solve_time]
+                       << " Setup = " << timer[setup_time]
                        << " Iter = " << timer[iter_time]
                        << " Bottom = " << timer[bottom_time] << "\n";
     }
 
-    return composite_norminf;
+    if (composite_norminf.empty()) return 0.0;
+    return *std::max_element(composite_norminf.begin(), composite_norminf.end());
 }
 
 // in  : Residual (res) on the finest AMR level
@@ -257,6 +319,351 @@ MLMG::oneIter (int iter)
     averageDownAndSync();
 }
 
+void
+MLMG::krylovSetup ()
+{
+    BL_PROFILE("MLMG::krylovSetup()");
+
+    if (!linop.isCellCentered()) {
+        amrex::Abort("MLMG: Krylov acceleration is only supported for cell-centered operators");
+    }
+
+    const int ncomp = linop.getNComp();
+
+    auto define = [&] (Vector<MultiFab>& v) {
+        v.resize(namrlevs);
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            if (v[alev].empty() or v[alev].boxArray() != rhs[alev].boxArray()
+                or v[alev].DistributionMap() != rhs[alev].DistributionMap()
+                or v[alev].nComp() != ncomp)
+            {
+                v[alev].define(rhs[alev].boxArray(), rhs[alev].DistributionMap(), ncomp, 0);
+            }
+        }
+    };
+
+    define(kry_x);
+    define(kry_r);
+    define(kry_z);
+    define(kry_t);
+    if (krylov == Krylov::fcg)
+    {
+        define(kry_p);
+        define(kry_q);
+        kry_pq.assign(ncomp, 0.0);
+    }
+    else
+    {
+        const int m = std::max(krylov_restart, 1);
+        define(kry_x0);
+        kry_V.resize(m+1);
+        kry_Z.resize(m);
+        for (auto& v : kry_V) define(v);
+        for (auto& z : kry_Z) define(z);
+        kry_H.assign(ncomp, Vector<Real>((m+1)*m, 0.0));
+        kry_cs.assign(ncomp, Vector<Real>(m, 0.0));
+        kry_sn.assign(ncomp, Vector<Real>(m, 0.0));
+        kry_g.assign(ncomp, Vector<Real>(m+1, 0.0));
+    }
+    kry_j = 0;
+}
+
+// Composite inner product of each component, without the global
+// reduction.  Covered coarse cells are masked out, and each level is
+// weighted by its cell volume relative to level 0.
+void
+MLMG::krylovDot (const Vector<MultiFab>& x, const Vector<MultiFab>& y, Real* result)
+{
+    const int ncomp = linop.getNComp();
+    for (int n = 0; n < ncomp; ++n) result[n] = 0.0;
+
+    Real vol = 1.0;
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        if (alev > 0) vol /= AMREX_D_TERM(linop.AMRRefRatio(alev-1),
+                                          *linop.AMRRefRatio(alev-1),
+                                          *linop.AMRRefRatio(alev-1));
+        for (int n = 0; n < ncomp; ++n)
+        {
+            if (fine_mask[alev]) {
+                result[n] += vol * MultiFab::Dot(*fine_mask[alev], x[alev], n, y[alev], n, 1, 0, true);
+            } else {
+                result[n] += vol * MultiFab::Dot(x[alev], n, y[alev], n, 1, 0, true);
+            }
+        }
+    }
+}
+
+// z = M(v): one MLMG cycle for the residual v, starting from kry_x whose
+// residual is kry_r.  The rhs is shifted by v - kry_r for the duration of
+// the cycle, so that the residuals the cycle computes from sol and rhs are
+// those of v.  sol is left at kry_x.
+void
+MLMG::krylovPrecond (Vector<MultiFab>& z, const Vector<MultiFab>& v, int iter)
+{
+    BL_PROFILE("MLMG::krylovPrecond()");
+
+    const int ncomp = linop.getNComp();
+    const bool shift_rhs = (&v != &kry_r);
+
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        MultiFab::Copy(*sol[alev], kry_x[alev], 0, 0, ncomp, 0);
+        if (shift_rhs)
+        {
+            MultiFab::LinComb(kry_t[alev], 1.0, v[alev], 0, -1.0, kry_r[alev], 0, 0, ncomp, 0);
+            MultiFab::Add(kry_t[alev], rhs[alev], 0, 0, ncomp, 0);
+            std::swap(rhs[alev], kry_t[alev]);
+        }
+    }
+    MultiFab::Copy(res[finest_amr_lev][0], v[finest_amr_lev], 0, 0, ncomp, 0);
+
+    oneIter(iter);
+
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        if (shift_rhs) std::swap(rhs[alev], kry_t[alev]);
+        MultiFab::LinComb(z[alev], 1.0, *sol[alev], 0, -1.0, kry_x[alev], 0, 0, ncomp, 0);
+        MultiFab::Copy(*sol[alev], kry_x[alev], 0, 0, ncomp, 0);
+    }
+}
+
+// w = A(z) on the composite grid, as the difference of the residuals at
+// kry_x and kry_x+z.  The boundary and coarse/fine terms cancel.  sol is
+// left at kry_x.
+void
+MLMG::krylovApply (Vector<MultiFab>& w, const Vector<MultiFab>& z)
+{
+    BL_PROFILE("MLMG::krylovApply()");
+
+    const int ncomp = linop.getNComp();
+
+    for (int alev = 0; alev < namrlevs; ++alev) {
+        MultiFab::LinComb(*sol[alev], 1.0, kry_x[alev], 0, 1.0, z[alev], 0, 0, ncomp, 0);
+    }
+
+    computeMLResidual(finest_amr_lev);
+
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        MultiFab::LinComb(w[alev], 1.0, kry_r[alev], 0, -1.0, res[alev][0], 0, 0, ncomp, 0);
+        MultiFab::Copy(*sol[alev], kry_x[alev], 0, 0, ncomp, 0);
+    }
+}
+
+// One step of flexible CG with the MLMG cycle as the preconditioner.
+// in  : sol and its composite residual in res
+// out : updated sol and its composite residual in res
+void
+MLMG::krylovFCGIter (int iter)
+{
+    BL_PROFILE("MLMG::krylovFCGIter()");
+
+    const int ncomp = linop.getNComp();
+
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        MultiFab::Copy(kry_x[alev], *sol[alev], 0, 0, ncomp, 0);
+        MultiFab::Copy(kry_r[alev], res[alev][0], 0, 0, ncomp, 0);
+    }
+
+    krylovPrecond(kry_z, kry_r, iter);
+
+    // p = z - (z,q_old)/(p_old,q_old) p_old keeps the new direction
+    // A-orthogonal to the last one even though M varies between steps.
+    if (iter == 0)
+    {
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            MultiFab::Copy(kry_p[alev], kry_z[alev], 0, 0, ncomp, 0);
+        }
+    }
+    else
+    {
+        Vector<Real> zq(ncomp);
+        krylovDot(kry_z, kry_q, zq.data());
+        ParallelDescriptor::ReduceRealSum(zq.data(), ncomp, rhs[0].color());
+        for (int n = 0; n < ncomp; ++n)
+        {
+            const Real beta = (kry_pq[n] != 0.0) ? -zq[n]/kry_pq[n] : 0.0;
+            for (int alev = 0; alev < namrlevs; ++alev) {
+                MultiFab::Xpay(kry_p[alev], beta, kry_z[alev], n, n, 1, 0);
+            }
+        }
+    }
+
+    krylovApply(kry_q, kry_p);
+
+    Vector<Real> dots(2*ncomp);
+    krylovDot(kry_p, kry_q, dots.data());
+    krylovDot(kry_p, kry_r, dots.data()+ncomp);
+    ParallelDescriptor::ReduceRealSum(dots.data(), 2*ncomp, rhs[0].color());
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        kry_pq[n] = dots[n];
+        const Real alpha = (dots[n] != 0.0) ? dots[ncomp+n]/dots[n] : 0.0;
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            MultiFab::Saxpy(*sol[alev], alpha, kry_p[alev], n, n, 1, 0);
+        }
+    }
+
+    // The true residual rather than the recurrence r - alpha q: the next
+    // cycle also needs the coarse/fine boundary values of the new sol.
+    computeMLResidual(finest_amr_lev);
+}
+
+// One step of restarted flexible GMRES with the MLMG cycle as the
+// preconditioner.  The iterate is formed after every step so that sol and
+// the residual in res are always current, and the cycle and the operator
+// are applied about it rather than about the restart iterate kry_x0.
+// in  : sol and its composite residual in res
+// out : updated sol and its composite residual in res
+void
+MLMG::krylovFGMRESIter (int iter)
+{
+    BL_PROFILE("MLMG::krylovFGMRESIter()");
+
+    const int ncomp = linop.getNComp();
+    const int m = kry_Z.size();
+    const int j = kry_j;
+
+    for (int alev = 0; alev < namrlevs; ++alev)
+    {
+        MultiFab::Copy(kry_x[alev], *sol[alev], 0, 0, ncomp, 0);
+        MultiFab::Copy(kry_r[alev], res[alev][0], 0, 0, ncomp, 0);
+    }
+
+    if (j == 0)
+    {
+        for (int alev = 0; alev < namrlevs; ++alev)
+        {
+            MultiFab::Copy(kry_x0[alev], *sol[alev], 0, 0, ncomp, 0);
+            MultiFab::Copy(kry_V[0][alev], res[alev][0], 0, 0, ncomp, 0);
+        }
+        Vector<Real> rr(ncomp);
+        krylovDot(kry_r, kry_r, rr.data());
+        ParallelDescriptor::ReduceRealSum(rr.data(), ncomp, rhs[0].color());
+        for (int n = 0; n < ncomp; ++n)
+        {
+            const Real beta = std::sqrt(rr[n]);
+            std::fill(kry_g[n].begin(), kry_g[n].end(), 0.0);
+            kry_g[n][0] = beta;
+            if (beta > 0.0) {
+                for (int alev = 0; alev < namrlevs; ++alev) {
+                    kry_V[0][alev].mult(1.0/beta, n, 1);
+                }
+            }
+        }
+    }
+
+    // M and A are applied to v_j scaled to the size of the current
+    // residual.  With a unit v_j the difference of residuals in
+    // krylovApply would lose most of its digits to the magnitude of rhs.
+    Vector<MultiFab>& w = kry_V[j+1];
+    Vector<Real> scale(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        scale[n] = (kry_g[n][j] != 0.0) ? std::abs(kry_g[n][j]) : 1.0;
+    }
+    auto rescale = [&] (Vector<MultiFab>& v, bool up) {
+        for (int alev = 0; alev < namrlevs; ++alev) {
+            for (int n = 0; n < ncomp; ++n) {
+                v[alev].mult(up ? scale[n] : 1.0/scale[n], n, 1);
+            }
+        }
+    };
+
+    rescale(kry_V[j], true);
+    krylovPrecond(kry_Z[j], kry_V[j], iter);
+    krylovApply(w, kry_Z[j]);
+    rescale(kry_V[j], false);
+    rescale(kry_Z[j], false);
+    rescale(w, false);
+
+    // Classical Gram-Schmidt, done twice, so that each pass needs a
+    // single reduction.
+    auto H = [&] (int n, int i, int k) -> Real& { return kry_H[n][k*(m+1)+i]; };
+    for (int n = 0; n < ncomp; ++n) {
+        for (int i = 0; i <= j+1; ++i) H(n,i,j) = 0.0;
+    }
+    Vector<Real> h((j+1)*ncomp);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int i = 0; i <= j; ++i) {
+            krylovDot(w, kry_V[i], h.data()+i*ncomp);
+        }
+        ParallelDescriptor::ReduceRealSum(h.data(), h.size(), rhs[0].color());
+        for (int i = 0; i <= j; ++i)
+        {
+            for (int n = 0; n < ncomp; ++n)
+            {
+                H(n,i,j) += h[i*ncomp+n];
+                for (int alev = 0; alev < namrlevs; ++alev) {
+                    MultiFab::Saxpy(w[alev], -h[i*ncomp+n], kry_V[i][alev], n, n, 1, 0);
+                }
+            }
+        }
+    }
+
+    Vector<Real> ww(ncomp);
+    krylovDot(w, w, ww.data());
+    ParallelDescriptor::ReduceRealSum(ww.data(), ncomp, rhs[0].color());
+
+    Vector<Real> y(j+1);
+    for (int n = 0; n < ncomp; ++n)
+    {
+        const Real hnorm = std::sqrt(ww[n]);
+        H(n,j+1,j) = hnorm;
+        if (hnorm > 0.0) {
+            for (int alev = 0; alev < namrlevs; ++alev) {
+                w[alev].mult(1.0/hnorm, n, 1);
+            }
+        }
+
+        // Apply the previous Givens rotations to the new column and
+        // eliminate its subdiagonal entry.
+        auto& cs = kry_cs[n];
+        auto& sn = kry_sn[n];
+        auto& g  = kry_g[n];
+        for (int i = 0; i < j; ++i)
+        {
+            const Real t = cs[i]*H(n,i,j) + sn[i]*H(n,i+1,j);
+            H(n,i+1,j) = -sn[i]*H(n,i,j) + cs[i]*H(n,i+1,j);
+            H(n,i,j) = t;
+        }
+        const Real d = std::sqrt(H(n,j,j)*H(n,j,j) + H(n,j+1,j)*H(n,j+1,j));
+        if (d > 0.0) {
+            cs[j] = H(n,j,j)/d;
+            sn[j] = H(n,j+1,j)/d;
+        } else {
+            cs[j] = 1.0;
+            sn[j] = 0.0;
+        }
+        H(n,j,j) = d;
+        H(n,j+1,j) = 0.0;
+        g[j+1] = -sn[j]*g[j];
+        g[j]   =  cs[j]*g[j];
+
+        for (int i = j; i >= 0; --i)
+        {
+            Real t = g[i];
+            for (int k = i+1; k <= j; ++k) t -= H(n,i,k)*y[k];
+            y[i] = (H(n,i,i) != 0.0) ? t/H(n,i,i) : 0.0;
+        }
+
+        for (int alev = 0; alev < namrlevs; ++alev)
+        {
+            MultiFab::Copy(*sol[alev], kry_x0[alev], n, n, 1, 0);
+            for (int i = 0; i <= j; ++i) {
+                MultiFab::Saxpy(*sol[alev], y[i], kry_Z[i][alev], n, n, 1, 0);
+            }
+        }
+    }
+
+    computeMLResidual(finest_amr_lev);
+
+    kry_j = (j+1 == m) ? 0 : j+1;
+}
+
 // Compute multi-level Residual (res) up to amrlevmax.
 void
 MLMG::computeMLResidual (int amrlevmax)
@@ -384,17 +791,27 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             skip_fillboundary = false;
         }
 
-        // rescor = res - L(cor)
-        computeResOfCorrection(amrlev, mglev);
-
-        if (verbose >= 4)
+        if (do_fused_restriction && verbose < 4)
         {
-            Real norm = rescor[amrlev][mglev].norm0();
-            amrex::Print() << "   DN: Norm after  smooth " << norm << "\n";
+            // res_crse = R(res - L(cor)) in one pass, without storing rescor
+            linop.correctionResidualRestriction(amrlev, mglev+1, res[amrlev][mglev+1],
+                                                *cor[amrlev][mglev], res[amrlev][mglev],
+                                                rescor[amrlev][mglev]);
         }
+        else
+        {
+            // rescor = res - L(cor)
+            computeResOfCorrection(amrlev, mglev);
 
-        // res_crse = R(rescor_fine); this provides res/b to the level below
-        linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
+            if (verbose >= 4)
+            {
+                Real norm = rescor[amrlev][mglev].norm0();
+                amrex::Print() << "   DN: Norm after  smooth " << norm << "\n";
+            }
+
+            // res_crse = R(rescor_fine); this provides res/b to the level below
+            linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
+        }
     }
     BL_PROFILE_VAR_STOP(blp_down);
 
@@ -759,11 +1176,33 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithHypre(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::amg)
+        {
+            int ret = bottomSolveWithAMG(x, *bottom_b);
+            if (ret != 0 && verbose >= 1) {
+                amrex::Print() << "MLMG: Bottom solve failed.\n";
+            }
+            const int n = ret==0 ? nub : nuf;
+            for (int i = 0; i < n; ++i) {
+                linop.smooth(amrlev, mglev, x, b);
+            }
+        }
         else
         {
-            MLCGSolver cg_solver(linop);
+            MLCGSolver::Solver cg_type;
+            switch (bottom_solver)
+            {
+            case BottomSolver::cg:            cg_type = MLCGSolver::Solver::CG;           break;
+            case BottomSolver::pipe_bicgstab: cg_type = MLCGSolver::Solver::PipeBiCGStab; break;
+            case BottomSolver::pipe_cg:       cg_type = MLCGSolver::Solver::PipeCG;       break;
+            case BottomSolver::sstep_cg:      cg_type = MLCGSolver::Solver::SStepCG;      break;
+            default:                          cg_type = MLCGSolver::Solver::BiCGStab;
+            }
+
+            MLCGSolver cg_solver(linop, cg_type);
             cg_solver.setVerbose(bottom_verbose);
             cg_solver.setMaxIter(bottom_maxiter);
+            cg_solver.setSStep(bottom_sstep);
             
             const Real cg_rtol = 1.e-4;
             const Real cg_atol = -1.0;
@@ -784,53 +1223,60 @@ MLMG::actualBottomSolve ()
 }
 
 // Compute single-level masked inf-norm of Residual (res).
-Real
+Vector<Real>
 MLMG::ResNormInf (int alev, bool local)
 {
     BL_PROFILE("MLMG::ResNormInf()");
     const int mglev = 0;
-    Real norm = 0.0;
-    for (int n = 0; n < linop.getNComp(); n++)
-      {
-	Real newnorm = 0.0;
-	if (fine_mask[alev]) {
-	  newnorm = res[alev][mglev].norm0(*fine_mask[alev],n,0,local);
-	} else {
-	  newnorm = res[alev][mglev].norm0(n,0,local);
-	}
-	if (newnorm > norm) norm = newnorm;
-      }
+    const int ncomp = linop.getNComp();
+    Vector<Real> norm(ncomp);
+    for (int n = 0; n < ncomp; n++)
+    {
+        if (fine_mask[alev]) {
+            norm[n] = res[alev][mglev].norm0(*fine_mask[alev],n,0,true);
+        } else {
+            norm[n] = res[alev][mglev].norm0(n,0,true);
+        }
+    }
+    if (!local) ParallelDescriptor::ReduceRealMax(norm.data(), ncomp, rhs[0].color());
     return norm;
 }
 
-// Computes multi-level masked inf-norm of Residual (res).
-Real
+Vector<Real>
 MLMG::MLResNormInf (int alevmax, bool local)
 {
     BL_PROFILE("MLMG::MLResNormInf()");
-    Real r = 0.0;
+    const int ncomp = linop.getNComp();
+    Vector<Real> r(ncomp, 0.0);
     for (int alev = 0; alev <= alevmax; ++alev)
     {
-        r = std::max(r, ResNormInf(alev,true));
+        const Vector<Real>& rlev = ResNormInf(alev,true);
+        for (int n = 0; n < ncomp; ++n) {
+            r[n] = std::max(r[n], rlev[n]);
+        }
     }
-    if (!local) ParallelDescriptor::ReduceRealMax(r, rhs[0].color());
+    if (!local) ParallelDescriptor::ReduceRealMax(r.data(), ncomp, rhs[0].color());
     return r;
 }
 
-// Compute multi-level masked inf-norm of RHS (rhs).
-Real
+Vector<Real>
 MLMG::MLRhsNormInf (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
-    Real r = 0.0;
+    const int ncomp = linop.getNComp();
+    Vector<Real> r(ncomp, 0.0);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
-        if (alev < finest_amr_lev) {
-            r = std::max(r, rhs[alev].norm0(*fine_mask[alev],0,0,local));
-        } else {
-            r = std::max(r, rhs[alev].norm0(0,0,local));
+        for (int n = 0; n < ncomp; ++n)
+        {
+            if (alev < finest_amr_lev) {
+                r[n] = std::max(r[n], rhs[alev].norm0(*fine_mask[alev],n,0,true));
+            } else {
+                r[n] = std::max(r[n], rhs[alev].norm0(n,0,true));
+            }
         }
     }
+    if (!local) ParallelDescriptor::ReduceRealMax(r.data(), ncomp, rhs[0].color());
     return r;
 }
 
@@ -885,12 +1331,13 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     AMREX_ASSERT(namrlevs <= a_rhs.size());
 
     timer.assign(ntimers, 0.0);
+    Real setup_start_time = amrex::second();
 
     const int ncomp = linop.getNComp();
 
-    if (!linop_prepared) {
+    if (linop.needsUpdate()) {
         linop.prepareForSolve();
-        linop_prepared = true;
+        linop.m_needs_update = false;
     }
 
     sol.resize(namrlevs);
@@ -903,18 +1350,30 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         }
         else
         {
-            sol_raii[alev].reset(new MultiFab(a_sol[alev]->boxArray(),
-                                              a_sol[alev]->DistributionMap(), ncomp, 1));
+            if (sol_raii[alev] == nullptr
+                || sol_raii[alev]->boxArray() != a_sol[alev]->boxArray()
+                || sol_raii[alev]->DistributionMap() != a_sol[alev]->DistributionMap())
+            {
+                sol_raii[alev].reset(new MultiFab(a_sol[alev]->boxArray(),
+                                                  a_sol[alev]->DistributionMap(), ncomp, 1));
+            }
             sol_raii[alev]->setVal(0.0);
             MultiFab::Copy(*sol_raii[alev], *a_sol[alev], 0, 0, ncomp, 0);
             sol[alev] = sol_raii[alev].get();
         }
     }
     
+    // The temporaries below live on the grids of the linop, which do not
+    // change over the lifetime of this object, so they are allocated by
+    // the first solve only.
+    const bool first_solve = rhs.empty();
+
     rhs.resize(namrlevs);
     for (int alev = 0; alev < namrlevs; ++alev)
     {
-      rhs[alev].define(a_rhs[alev]->boxArray(), a_rhs[alev]->DistributionMap(), ncomp, 0);
+      if (first_solve) {
+          rhs[alev].define(a_rhs[alev]->boxArray(), a_rhs[alev]->DistributionMap(), ncomp, 0);
+      }
       MultiFab::Copy(rhs[alev], *a_rhs[alev], 0, 0, ncomp, 0);
       linop.applyMetricTerm(alev, 0, rhs[alev]);
     }
@@ -956,56 +1415,63 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         }
     }
 
-    int ng = linop.isCellCentered() ? 0 : 1;
-    linop.make(res, ncomp, ng);
-    linop.make(rescor, ncomp, ng);
-    for (int alev = 0; alev <= finest_amr_lev; ++alev)
+    if (first_solve)
     {
-        const int nmglevs = linop.NMGLevels(alev);
-        for (int mglev = 0; mglev < nmglevs; ++mglev)
+        int ng = linop.isCellCentered() ? 0 : 1;
+        linop.make(res, ncomp, ng);
+        linop.make(rescor, ncomp, ng);
+
+        ng = 1;
+        cor.resize(namrlevs);
+        for (int alev = 0; alev <= finest_amr_lev; ++alev)
         {
-            rescor[alev][mglev].setVal(0.0);
+            const int nmglevs = linop.NMGLevels(alev);
+            cor[alev].resize(nmglevs);
+            for (int mglev = 0; mglev < nmglevs; ++mglev)
+            {
+                cor[alev][mglev].reset(new MultiFab(res[alev][mglev].boxArray(),
+                                                    res[alev][mglev].DistributionMap(),
+                                                    ncomp, ng));
+            }
         }
+
+        cor_hold.resize(std::max(namrlevs-1,1));
+        {
+            const int alev = 0;
+            const int nmglevs = linop.NMGLevels(alev);
+            cor_hold[alev].resize(nmglevs);
+            for (int mglev = 0; mglev < nmglevs-1; ++mglev)
+            {
+                cor_hold[alev][mglev].reset(new MultiFab(cor[alev][mglev]->boxArray(),
+                                                         cor[alev][mglev]->DistributionMap(),
+                                                         ncomp, ng));
+            }
+        }
+        for (int alev = 1; alev < finest_amr_lev; ++alev)
+        {
+            cor_hold[alev].resize(1);
+            cor_hold[alev][0].reset(new MultiFab(cor[alev][0]->boxArray(),
+                                                 cor[alev][0]->DistributionMap(),
+                                                 ncomp, ng));
+        }
+
+        buildFineMask();
     }
 
-    ng = 1;
-    cor.resize(namrlevs);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
         const int nmglevs = linop.NMGLevels(alev);
-        cor[alev].resize(nmglevs);
         for (int mglev = 0; mglev < nmglevs; ++mglev)
         {
-            cor[alev][mglev].reset(new MultiFab(res[alev][mglev].boxArray(),
-                                                res[alev][mglev].DistributionMap(),
-                                                ncomp, ng));
+            rescor[alev][mglev].setVal(0.0);
             cor[alev][mglev]->setVal(0.0);
         }
     }
-
-    cor_hold.resize(std::max(namrlevs-1,1));
-    {
-        const int alev = 0;
-        const int nmglevs = linop.NMGLevels(alev);
-        cor_hold[alev].resize(nmglevs);
-        for (int mglev = 0; mglev < nmglevs-1; ++mglev)
-        {
-            cor_hold[alev][mglev].reset(new MultiFab(cor[alev][mglev]->boxArray(),
-                                                     cor[alev][mglev]->DistributionMap(),
-                                                     ncomp, ng));
-            cor_hold[alev][mglev]->setVal(0.0);
+    for (auto& ch : cor_hold) {
+        for (auto& mf : ch) {
+            if (mf) mf->setVal(0.0);
         }
     }
-    for (int alev = 1; alev < finest_amr_lev; ++alev)
-    {
-        cor_hold[alev].resize(1);
-        cor_hold[alev][0].reset(new MultiFab(cor[alev][0]->boxArray(),
-                                             cor[alev][0]->DistributionMap(),
-                                             ncomp, ng));
-        cor_hold[alev][0]->setVal(0.0);
-    }
-
-    buildFineMask();
 
     if (linop.m_parent) do_nsolve = false;  // no embeded N-Solve
     if (linop.m_domain_covered[0]) do_nsolve = false;
@@ -1017,6 +1483,8 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
         prepareForNSolve();
     }
 
+    timer[setup_time] = amrex::second() - setup_start_time;
+
     if (verbose >= 2) {
         amrex::Print() << "MLMG: # of AMR levels: " << namrlevs << "\n"
                        << "      # of MG levels on the coarsest AMR level: " << linop.NMGLevels(0)
@@ -1105,9 +1573,9 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
         }
     }
 
-    if (!linop_prepared) {
+    if (linop.needsUpdate()) {
         linop.prepareForSolve();
-        linop_prepared = true;
+        linop.m_needs_update = false;
     }
     
     const auto& amrrr = linop.AMRRefRatio();
@@ -1168,9 +1636,9 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
         rh[alev].setVal(0.0);
     }
 
-    if (!linop_prepared) {
+    if (linop.needsUpdate()) {
         linop.prepareForSolve();
-        linop_prepared = true;
+        linop.m_needs_update = false;
     }
 
     const auto& amrrr = linop.AMRRefRatio();
@@ -1307,4 +1775,69 @@ MLMG::bottomSolveWithHypre (MultiFab& x, const MultiFab& b)
 #endif
 }
 
+int
+MLMG::bottomSolveWithAMG (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLMG::bottomSolveWithAMG()");
+
+    if (!linop.isCellCentered() || linop.getNComp() != 1) {
+        amrex::Abort("MLMG: the amg bottom solver supports single-component cell-centered problems only");
+    }
+
+    const BoxArray& ba = linop.m_grids[0].back();
+    const DistributionMapping& dm = linop.m_dmap[0].back();
+
+    if (amg_solver == nullptr)
+    {
+        const Geometry& geom = linop.m_geom[0].back();
+        MPI_Comm comm = linop.BottomCommunicator();
+        amg_solver.reset(new MLAMG(ba, dm, geom, comm));
+        amg_solver->setVerbose(bottom_verbose);
+    }
+
+    if (!amg_coeffs_current)
+    {
+        amg_solver->setScalars(linop.getAScalar(), linop.getBScalar());
+
+        auto ac = linop.getACoeffs(0, linop.NMGLevels(0)-1);
+        if (ac)
+        {
+            amg_solver->setACoeffs(*ac);
+        }
+        else
+        {
+            MultiFab alpha(ba,dm,1,0);
+            alpha.setVal(0.0);
+            amg_solver->setACoeffs(alpha);
+        }
+
+        auto bc = linop.getBCoeffs(0, linop.NMGLevels(0)-1);
+        if (bc[0])
+        {
+            amg_solver->setBCoeffs(bc);
+        }
+        else
+        {
+            std::array<MultiFab,AMREX_SPACEDIM> beta;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                beta[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+                beta[idim].setVal(1.0);
+            }
+            amg_solver->setBCoeffs(amrex::GetArrOfConstPtrs(beta));
+        }
+
+        const Real* dx = linop.m_geom[0][0].CellSize();
+        int crse_ratio = linop.m_coarse_data_crse_ratio > 0 ? linop.m_coarse_data_crse_ratio : 1;
+        RealVect bclocation(AMREX_D_DECL(0.5*dx[0]*crse_ratio,
+                                         0.5*dx[1]*crse_ratio,
+                                         0.5*dx[2]*crse_ratio));
+        amg_solver->setDomainBC(linop.m_lobc, linop.m_hibc, bclocation);
+
+        amg_coeffs_current = true;
+    }
+
+    return amg_solver->solve(x, b, 1.e-4, -1., bottom_maxiter);
+}
+
 }
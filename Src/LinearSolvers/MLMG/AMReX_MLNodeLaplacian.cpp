@@ -97,6 +97,7 @@ void
 MLNodeLaplacian::setSigma (int amrlev, const MultiFab& a_sigma)
 {
     MultiFab::Copy(*m_sigma[amrlev][0][0], a_sigma, 0, 0, 1, 0);
+    m_needs_update = true;
 }
 
 void
@@ -973,6 +974,66 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    m_compact_stencil.clear();
+#if (AMREX_SPACEDIM == 3)
+    if (m_use_stencil_cache && m_coarsening_strategy == CoarseningStrategy::Sigma) {
+        buildCompactStencil();
+    }
+#endif
+}
+
+void
+MLNodeLaplacian::buildCompactStencil ()
+{
+#if (AMREX_SPACEDIM == 3)
+    BL_PROFILE("MLNodeLaplacian::buildCompactStencil()");
+
+    m_compact_stencil.resize(m_num_amr_levels);
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_compact_stencil[amrlev].resize(m_num_mg_levels[amrlev]);
+        for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+        {
+            // Levels using the harmonic average keep their kernels.
+            if (m_use_harmonic_average && mglev > 0) continue;
+
+            const MultiFab& sigma = *m_sigma[amrlev][mglev][0];
+            const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+            const BoxArray& nba = amrex::convert(m_grids[amrlev][mglev], IntVect::TheNodeVector());
+
+            // A node reads the couplings of its lower neighbors, so the
+            // stencil is needed on one layer of ghost nodes on the low sides.
+            m_compact_stencil[amrlev][mglev].reset
+                (new MultiFab(nba, m_dmap[amrlev][mglev], ncstencil, 1));
+            MultiFab& csten = *m_compact_stencil[amrlev][mglev];
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                FArrayBox sgfab;
+                for (MFIter mfi(csten); mfi.isValid(); ++mfi)
+                {
+                    const Box& bx = amrex::growLo(amrex::growLo(amrex::growLo(mfi.validbox(),
+                                                                              0, 1), 1, 1), 2, 1);
+                    // The diagonal of a ghost node needs sigma beyond the
+                    // ghost cells; it is never used, so zero will do.
+                    const Box& cbx = amrex::grow(amrex::enclosedCells(bx), 1);
+                    sgfab.resize(cbx);
+                    sgfab.setVal(0.0);
+                    const Box& ovlp = cbx & sigma[mfi].box();
+                    sgfab.copy(sigma[mfi], ovlp, 0, ovlp, 0, 1);
+
+                    amrex_mlndlap_set_csten(BL_TO_FORTRAN_BOX(bx),
+                                            BL_TO_FORTRAN_ANYD(csten[mfi]),
+                                            BL_TO_FORTRAN_ANYD(sgfab),
+                                            dxinv);
+                }
+            }
+        }
+    }
+#endif
 }
 
 void
@@ -1228,12 +1289,14 @@ MLNodeLaplacian::applyBC (int amrlev, int mglev, MultiFab& phi, BCMode/* bc_mode
 }
 
 void
-MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in) const
+MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& in,
+                         Region region) const
 {
     BL_PROFILE("MLNodeLaplacian::Fapply()");
 
     const auto& sigma = m_sigma[amrlev][mglev];
     const auto& stencil = m_stencil[amrlev][mglev];
+    const MultiFab* csten = compactStencil(amrlev, mglev);
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
     const Box& domain_box = amrex::surroundingNodes(m_geom[amrlev][mglev].Domain());
@@ -1244,143 +1307,160 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
 #endif
     for (MFIter mfi(out,true); mfi.isValid(); ++mfi)
     {
-        const Box& bx = mfi.tilebox();
+        const BoxList& bl = regionBoxes(mfi.tilebox(), mfi.validbox(), region);
         const FArrayBox& xfab = in[mfi];
         FArrayBox& yfab = out[mfi];
 
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        for (const Box& bx : bl)
         {
-            amrex_mlndlap_adotx_sten(BL_TO_FORTRAN_BOX(bx),
-                                     BL_TO_FORTRAN_ANYD(yfab),
-                                     BL_TO_FORTRAN_ANYD(xfab),
-                                     BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
-                                     BL_TO_FORTRAN_ANYD(dmsk[mfi]));
-        }
-        else if (m_use_harmonic_average && mglev > 0)
-        {
-            AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
-                         const FArrayBox& syfab = (*sigma[1])[mfi];,
-                         const FArrayBox& szfab = (*sigma[2])[mfi];);
+            if (m_coarsening_strategy == CoarseningStrategy::RAP)
+            {
+                amrex_mlndlap_adotx_sten(BL_TO_FORTRAN_BOX(bx),
+                                         BL_TO_FORTRAN_ANYD(yfab),
+                                         BL_TO_FORTRAN_ANYD(xfab),
+                                         BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
+                                         BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+            }
+#if (AMREX_SPACEDIM == 3)
+            else if (csten)
+            {
+                amrex_mlndlap_adotx_csten(BL_TO_FORTRAN_BOX(bx),
+                                          BL_TO_FORTRAN_ANYD(yfab),
+                                          BL_TO_FORTRAN_ANYD(xfab),
+                                          BL_TO_FORTRAN_ANYD((*csten)[mfi]),
+                                          BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+            }
+#endif
+            else if (m_use_harmonic_average && mglev > 0)
+            {
+                AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
+                             const FArrayBox& syfab = (*sigma[1])[mfi];,
+                             const FArrayBox& szfab = (*sigma[2])[mfi];);
 
-            amrex_mlndlap_adotx_ha(BL_TO_FORTRAN_BOX(bx),
-                                   BL_TO_FORTRAN_ANYD(yfab),
-                                   BL_TO_FORTRAN_ANYD(xfab),
-                                   AMREX_D_DECL(BL_TO_FORTRAN_ANYD(sxfab),
-                                                BL_TO_FORTRAN_ANYD(syfab),
-                                                BL_TO_FORTRAN_ANYD(szfab)),
-                                   BL_TO_FORTRAN_ANYD(dmsk[mfi]),
-                                   dxinv, BL_TO_FORTRAN_BOX(domain_box),
-                                   m_lobc.data(), m_hibc.data());
-        }
-        else
-        {
-            const FArrayBox& sfab = (*sigma[0])[mfi];
+                amrex_mlndlap_adotx_ha(BL_TO_FORTRAN_BOX(bx),
+                                       BL_TO_FORTRAN_ANYD(yfab),
+                                       BL_TO_FORTRAN_ANYD(xfab),
+                                       AMREX_D_DECL(BL_TO_FORTRAN_ANYD(sxfab),
+                                                    BL_TO_FORTRAN_ANYD(syfab),
+                                                    BL_TO_FORTRAN_ANYD(szfab)),
+                                       BL_TO_FORTRAN_ANYD(dmsk[mfi]),
+                                       dxinv, BL_TO_FORTRAN_BOX(domain_box),
+                                       m_lobc.data(), m_hibc.data());
+            }
+            else
+            {
+                const FArrayBox& sfab = (*sigma[0])[mfi];
 
-            amrex_mlndlap_adotx_aa(BL_TO_FORTRAN_BOX(bx),
-                                   BL_TO_FORTRAN_ANYD(yfab),
-                                   BL_TO_FORTRAN_ANYD(xfab),
-                                   BL_TO_FORTRAN_ANYD(sfab),
-                                   BL_TO_FORTRAN_ANYD(dmsk[mfi]),
-                                   dxinv, BL_TO_FORTRAN_BOX(domain_box),
-                                   m_lobc.data(), m_hibc.data());
+                amrex_mlndlap_adotx_aa(BL_TO_FORTRAN_BOX(bx),
+                                       BL_TO_FORTRAN_ANYD(yfab),
+                                       BL_TO_FORTRAN_ANYD(xfab),
+                                       BL_TO_FORTRAN_ANYD(sfab),
+                                       BL_TO_FORTRAN_ANYD(dmsk[mfi]),
+                                       dxinv, BL_TO_FORTRAN_BOX(domain_box),
+                                       m_lobc.data(), m_hibc.data());
+            }
         }
     }
 }
 
 void
-MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs) const
+MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                          Region region) const
 {
     BL_PROFILE("MLNodeLaplacian::Fsmooth()");
 
     const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
 
-    if (m_use_gauss_seidel)
-    {
-        const auto& sigma = m_sigma[amrlev][mglev];
-        const auto& stencil = m_stencil[amrlev][mglev];
-        const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    const auto& sigma = m_sigma[amrlev][mglev];
+    const auto& stencil = m_stencil[amrlev][mglev];
+    const MultiFab* csten = compactStencil(amrlev, mglev);
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
-        const Box& domain_box = amrex::surroundingNodes(m_geom[amrlev][mglev].Domain());
+    const Box& domain_box = amrex::surroundingNodes(m_geom[amrlev][mglev].Domain());
 
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
-        {
+    if (m_use_gauss_seidel)
+    {
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-            for (MFIter mfi(sol); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.validbox();
-                amrex_mlndlap_gauss_seidel_sten(BL_TO_FORTRAN_BOX(bx),
-                                                BL_TO_FORTRAN_ANYD(sol[mfi]),
-                                                BL_TO_FORTRAN_ANYD(rhs[mfi]),
-                                                BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
-                                                BL_TO_FORTRAN_ANYD(dmsk[mfi]));
-            }
-        }
-        else if (m_use_harmonic_average && mglev > 0)
+        for (MFIter mfi(sol); mfi.isValid(); ++mfi)
         {
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-            for (MFIter mfi(sol); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.validbox();
-                AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
-                             const FArrayBox& syfab = (*sigma[1])[mfi];,
-                             const FArrayBox& szfab = (*sigma[2])[mfi];);
+            const Box& vbx = mfi.validbox();
+            const BoxList& bl = regionBoxes(vbx, vbx, region);
 
-                amrex_mlndlap_gauss_seidel_ha(BL_TO_FORTRAN_BOX(bx),
-                                              BL_TO_FORTRAN_ANYD(sol[mfi]),
-                                              BL_TO_FORTRAN_ANYD(rhs[mfi]),
-                                              AMREX_D_DECL(BL_TO_FORTRAN_ANYD(sxfab),
-                                                           BL_TO_FORTRAN_ANYD(syfab),
-                                                           BL_TO_FORTRAN_ANYD(szfab)),
-                                              BL_TO_FORTRAN_ANYD(dmsk[mfi]),
-                                              dxinv, BL_TO_FORTRAN_BOX(domain_box),
-                                              m_lobc.data(), m_hibc.data());
-            }
-        }
-        else
-        {
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-            for (MFIter mfi(sol); mfi.isValid(); ++mfi)
+            for (const Box& bx : bl)
             {
-                const Box& bx = mfi.validbox();
-                const FArrayBox& sfab = (*sigma[0])[mfi];
-
-                amrex_mlndlap_gauss_seidel_aa(BL_TO_FORTRAN_BOX(bx),
-                                              BL_TO_FORTRAN_ANYD(sol[mfi]),
-                                              BL_TO_FORTRAN_ANYD(rhs[mfi]),
-                                              BL_TO_FORTRAN_ANYD(sfab),
-                                              BL_TO_FORTRAN_ANYD(dmsk[mfi]),
-                                              dxinv, BL_TO_FORTRAN_BOX(domain_box),
-                                              m_lobc.data(), m_hibc.data());
+                if (m_coarsening_strategy == CoarseningStrategy::RAP)
+                {
+                    amrex_mlndlap_gauss_seidel_sten(BL_TO_FORTRAN_BOX(bx),
+                                                    BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                                    BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                                    BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
+                                                    BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+                }
+#if (AMREX_SPACEDIM == 3)
+                else if (csten)
+                {
+                    amrex_mlndlap_gauss_seidel_csten(BL_TO_FORTRAN_BOX(bx),
+                                                     BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                                     BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                                     BL_TO_FORTRAN_ANYD((*csten)[mfi]),
+                                                     BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+                }
+#endif
+                else if (m_use_harmonic_average && mglev > 0)
+                {
+                    AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
+                                 const FArrayBox& syfab = (*sigma[1])[mfi];,
+                                 const FArrayBox& szfab = (*sigma[2])[mfi];);
+
+                    amrex_mlndlap_gauss_seidel_ha(BL_TO_FORTRAN_BOX(bx),
+                                                  BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                                  BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                                  AMREX_D_DECL(BL_TO_FORTRAN_ANYD(sxfab),
+                                                               BL_TO_FORTRAN_ANYD(syfab),
+                                                               BL_TO_FORTRAN_ANYD(szfab)),
+                                                  BL_TO_FORTRAN_ANYD(dmsk[mfi]),
+                                                  dxinv, BL_TO_FORTRAN_BOX(domain_box),
+                                                  m_lobc.data(), m_hibc.data());
+                }
+                else
+                {
+                    const FArrayBox& sfab = (*sigma[0])[mfi];
+
+                    amrex_mlndlap_gauss_seidel_aa(BL_TO_FORTRAN_BOX(bx),
+                                                  BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                                  BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                                  BL_TO_FORTRAN_ANYD(sfab),
+                                                  BL_TO_FORTRAN_ANYD(dmsk[mfi]),
+                                                  dxinv, BL_TO_FORTRAN_BOX(domain_box),
+                                                  m_lobc.data(), m_hibc.data());
+                }
             }
         }
 
-        nodalSync(amrlev, mglev, sol);
+        if (region != Region::interior) {
+            nodalSync(amrlev, mglev, sol);
+        }
     }
     else
     {
+        // Jacobi needs A sol everywhere before it updates anything, so all
+        // the work is done once the ghost nodes are available.
+        if (region == Region::interior) return;
+
         MultiFab Ax(sol.boxArray(), sol.DistributionMap(), 1, 0);
         Fapply(amrlev, mglev, Ax, sol);
 
-        const auto& sigma = m_sigma[amrlev][mglev];
-        const auto& stencil = m_stencil[amrlev][mglev];
-        const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
-
-        const Box& domain_box = amrex::surroundingNodes(m_geom[amrlev][mglev].Domain());
-
-        if (m_coarsening_strategy == CoarseningStrategy::RAP)
-        {
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-            for (MFIter mfi(sol); mfi.isValid(); ++mfi)
+        for (MFIter mfi(sol,true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+
+            if (m_coarsening_strategy == CoarseningStrategy::RAP)
             {
-                const Box& bx = mfi.validbox();
                 amrex_mlndlap_jacobi_sten(BL_TO_FORTRAN_BOX(bx),
                                           BL_TO_FORTRAN_ANYD(sol[mfi]),
                                           BL_TO_FORTRAN_ANYD(Ax[mfi]),
@@ -1388,15 +1468,19 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                                           BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
                                           BL_TO_FORTRAN_ANYD(dmsk[mfi]));
             }
-        }
-        else if (m_use_harmonic_average && mglev > 0)
-        {
-#ifdef _OPENMP
-#pragma omp parallel
+#if (AMREX_SPACEDIM == 3)
+            else if (csten)
+            {
+                amrex_mlndlap_jacobi_csten(BL_TO_FORTRAN_BOX(bx),
+                                           BL_TO_FORTRAN_ANYD(sol[mfi]),
+                                           BL_TO_FORTRAN_ANYD(Ax[mfi]),
+                                           BL_TO_FORTRAN_ANYD(rhs[mfi]),
+                                           BL_TO_FORTRAN_ANYD((*csten)[mfi]),
+                                           BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+            }
 #endif
-            for (MFIter mfi(sol,true); mfi.isValid(); ++mfi)
+            else if (m_use_harmonic_average && mglev > 0)
             {
-                const Box& bx = mfi.tilebox();
                 AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
                              const FArrayBox& syfab = (*sigma[1])[mfi];,
                              const FArrayBox& szfab = (*sigma[2])[mfi];);
@@ -1412,15 +1496,8 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
                                         dxinv, BL_TO_FORTRAN_BOX(domain_box),
                                         m_lobc.data(), m_hibc.data());
             }
-        }
-        else
-        {
-#ifdef _OPENMP
-#pragma omp parallel
-#endif
-            for (MFIter mfi(sol,true); mfi.isValid(); ++mfi)
+            else
             {
-                const Box& bx = mfi.tilebox();
                 const FArrayBox& sfab = (*sigma[0])[mfi];
 
                 amrex_mlndlap_jacobi_aa(BL_TO_FORTRAN_BOX(bx),
@@ -1443,6 +1520,7 @@ MLNodeLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
 
     const auto& sigma = m_sigma[amrlev][mglev];
     const auto& stencil = m_stencil[amrlev][mglev];
+    const MultiFab* csten = compactStencil(amrlev, mglev);
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
     const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
 
@@ -1460,6 +1538,15 @@ MLNodeLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
                                          BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
                                          BL_TO_FORTRAN_ANYD(dmsk[mfi]));
         }
+#if (AMREX_SPACEDIM == 3)
+        else if (csten)
+        {
+            amrex_mlndlap_normalize_csten(BL_TO_FORTRAN_BOX(bx),
+                                          BL_TO_FORTRAN_ANYD(fab),
+                                          BL_TO_FORTRAN_ANYD((*csten)[mfi]),
+                                          BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+        }
+#endif
         else if (m_use_harmonic_average && mglev > 0)
         {
             AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
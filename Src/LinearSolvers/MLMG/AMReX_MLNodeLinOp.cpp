@@ -155,18 +155,63 @@ void
 MLNodeLinOp::apply (int amrlev, int mglev, MultiFab& out, MultiFab& in, BCMode bc_mode,
                     const MLMGBndry*) const
 {
-    applyBC(amrlev, mglev, in, bc_mode);
-    Fapply(amrlev, mglev, out, in);
+    if (m_overlap_halo)
+    {
+        in.FillBoundary_nowait(m_geom[amrlev][mglev].periodicity());
+        Fapply(amrlev, mglev, out, in, Region::interior);
+        in.FillBoundary_finish();
+        applyBC(amrlev, mglev, in, bc_mode, true);
+        Fapply(amrlev, mglev, out, in, Region::boundary);
+    }
+    else
+    {
+        applyBC(amrlev, mglev, in, bc_mode);
+        Fapply(amrlev, mglev, out, in);
+    }
 }
 
 void
 MLNodeLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
-    if (!skip_fillboundary) {
+    if (skip_fillboundary)
+    {
+        Fsmooth(amrlev, mglev, sol, rhs);
+    }
+    else if (m_overlap_halo)
+    {
+        sol.FillBoundary_nowait(m_geom[amrlev][mglev].periodicity());
+        Fsmooth(amrlev, mglev, sol, rhs, Region::interior);
+        sol.FillBoundary_finish();
+        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, true);
+        Fsmooth(amrlev, mglev, sol, rhs, Region::boundary);
+    }
+    else
+    {
         applyBC(amrlev, mglev, sol, BCMode::Homogeneous);
+        Fsmooth(amrlev, mglev, sol, rhs);
+    }
+}
+
+BoxList
+MLNodeLinOp::regionBoxes (const Box& bx, const Box& vbx, Region region)
+{
+    if (region == Region::all) {
+        return BoxList(bx);
+    }
+
+    const Box& inner = amrex::grow(vbx,-1);
+    if (region == Region::interior)
+    {
+        BoxList bl(bx.ixType());
+        const Box& ibx = bx & inner;
+        if (ibx.ok()) bl.push_back(ibx);
+        return bl;
+    }
+    else
+    {
+        return amrex::boxDiff(bx, inner);
     }
-    Fsmooth(amrlev, mglev, sol, rhs);
 }
 
 Real
@@ -1,21 +1,42 @@
+#include <algorithm>
+
 #include "AMReX_LoadBalanceKD.H"
 
 using namespace amrex;
 
-int KDTree::min_box_size = 4;
-
-KDTree::KDTree(const Box& domain, const FArrayBox& cost, int num_procs) {
+KDTree::KDTree(const Box& domain, const FArrayBox& cost, int num_procs,
+               int min_box_size_in)
+    : min_box_size(min_box_size_in)
+{
     Real total_cost = cost.sum(0);
     root = new KDNode(domain, total_cost, num_procs);
     buildKDTree(root, cost);
 }
 
+KDTree::KDTree(const Box& domain, Vector<BlockCost>& blocks, int num_procs,
+               int min_box_size_in)
+    : min_box_size(min_box_size_in)
+{
+    Real total_cost = 0.0;
+    for (const auto& b : blocks) {
+        BL_ASSERT(domain.contains(b.iv));
+        total_cost += b.cost;
+    }
+    root = new KDNode(domain, total_cost, num_procs);
+    buildKDTree(root, blocks.data(), blocks.data() + blocks.size());
+}
+
 KDTree::~KDTree() {
     freeKDTree(root);
 }
     
 void KDTree::GetBoxes(BoxList& bl, Vector<Real>& costs) {        
-    walkKDTree(root, bl, costs);
+    Vector<int> num_procs;
+    walkKDTree(root, bl, costs, num_procs);
+}
+
+void KDTree::GetBoxes(BoxList& bl, Vector<Real>& costs, Vector<int>& num_procs) {
+    walkKDTree(root, bl, costs, num_procs);
 }
     
 void KDTree::buildKDTree(KDNode* node, const FArrayBox& cost) {
@@ -29,6 +50,18 @@ void KDTree::buildKDTree(KDNode* node, const FArrayBox& cost) {
     }
 }
 
+void KDTree::buildKDTree(KDNode* node, BlockCost* begin, BlockCost* end) {
+    if (node->num_procs_left == 1) return;
+
+    BlockCost* mid;
+    bool success = partitionNode(node, begin, end, mid);
+
+    if (success) {
+        buildKDTree(node->left,  begin, mid);
+        buildKDTree(node->right, mid,   end);
+    }
+}
+
 void KDTree::freeKDTree(KDNode* node) {
     
     if (node != NULL) {
@@ -43,16 +76,18 @@ void KDTree::freeKDTree(KDNode* node) {
     }
 }
 
-void KDTree::walkKDTree(KDNode* node, BoxList& bl, Vector<Real>& costs) {
+void KDTree::walkKDTree(KDNode* node, BoxList& bl, Vector<Real>& costs,
+                        Vector<int>& num_procs) {
     
     if (node->left == NULL && node->right == NULL) {
         costs.push_back(node->cost);
         bl.push_back(node->box);
+        num_procs.push_back(node->num_procs_left);
         return;
     }
     
-    walkKDTree(node->left,  bl, costs);
-    walkKDTree(node->right, bl, costs);
+    walkKDTree(node->left,  bl, costs, num_procs);
+    walkKDTree(node->right, bl, costs, num_procs);
 }
 
 bool KDTree::partitionNode(KDNode* node, const FArrayBox& cost) {
@@ -60,13 +95,20 @@ bool KDTree::partitionNode(KDNode* node, const FArrayBox& cost) {
     const Box& box = node->box;
     BL_ASSERT(cost.box().contains(box));
     
+    // With an odd number of processes the left half gets fewer of them,
+    // and its share of the cost is scaled to match.  The partition routine
+    // splits at half of the cost it is given.
+    const int num_procs_left  = node->num_procs_left/2;
+    const int num_procs_right = node->num_procs_left - num_procs_left;
+    const Real split_cost = 2.0*node->cost*num_procs_left/node->num_procs_left;
+
     int split;
     Real cost_left, cost_right;
     Box left, right;
     int dir = getLongestDir(box);
     for (int i = 0; i < AMREX_SPACEDIM; ++i) {
         amrex_compute_best_partition(cost.dataPtr(), cost.loVect(), cost.hiVect(),
-                                     box.loVect(), box.hiVect(), node->cost, dir,
+                                     box.loVect(), box.hiVect(), split_cost, dir,
                                      &cost_left, &cost_right, &split);    
     
         bool success = splitBox(split, dir, box, left, right);        
@@ -89,8 +131,67 @@ bool KDTree::partitionNode(KDNode* node, const FArrayBox& cost) {
         }
     }
 
-    node->left  = new KDNode(left,  cost_left,  node->num_procs_left/2);
-    node->right = new KDNode(right, cost_right, node->num_procs_left/2);
+    node->left  = new KDNode(left,  cost_left,  num_procs_left);
+    node->right = new KDNode(right, cost_right, num_procs_right);
+
+    return true;
+}
+
+//
+// Same split as above, with the cost of each slice of the box summed from
+// the blocks instead of read from a dense FArrayBox.
+//
+bool KDTree::partitionNode(KDNode* node, BlockCost* begin, BlockCost* end,
+                           BlockCost*& mid) {
+
+    const Box& box = node->box;
+
+    const int num_procs_left  = node->num_procs_left/2;
+    const int num_procs_right = node->num_procs_left - num_procs_left;
+    const Real split_cost = 2.0*node->cost*num_procs_left/node->num_procs_left;
+
+    Real cost_left, cost_right;
+    Box left, right;
+    int dir = getLongestDir(box);
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) {
+        const int lo = box.smallEnd(dir);
+        const int hi = box.bigEnd(dir);
+        Vector<Real> slice_cost(hi-lo+1, 0.0);
+        for (const BlockCost* b = begin; b != end; ++b) {
+            slice_cost[b->iv[dir]-lo] += b->cost;
+        }
+
+        int split = lo;
+        Real cost_sum = 0.0;
+        for (int k = lo; k < hi; ++k) {
+            cost_sum += slice_cost[k-lo];
+            if (cost_sum >= 0.5*split_cost) {
+                split = k;
+                break;
+            }
+        }
+
+        bool success = splitBox(split, dir, box, left, right);
+        if (not success) return false;
+
+        mid = std::partition(begin, end,
+                             [&left] (const BlockCost& b) { return left.contains(b.iv); });
+
+        cost_left = 0.0;
+        for (const BlockCost* b = begin; b != mid; ++b) cost_left += b->cost;
+        cost_right = 0.0;
+        for (const BlockCost* b = mid; b != end; ++b) cost_right += b->cost;
+
+        // if this happens try a new direction
+        if (cost_left < 1e-12 or cost_right < 1e-12) {
+            dir = (dir + 1) % AMREX_SPACEDIM;
+        } else {
+            break;
+        }
+    }
+
+    node->left  = new KDNode(left,  cost_left,  num_procs_left);
+    node->right = new KDNode(right, cost_right, num_procs_right);
 
     return true;
 }
@@ -133,3 +234,126 @@ bool KDTree::splitBox(int split, int dir,
 
     return true;
 }
+
+namespace loadBalanceKD {
+
+void balanceLevel(const MultiFab& cost, const IntVect& blocking_factor,
+                  const IntVect& max_grid_size, int num_procs,
+                  BoxArray& new_ba, DistributionMapping& new_dm) {
+
+    BL_PROFILE("loadBalanceKD::balanceLevel()");
+
+    const BoxArray& ba = cost.boxArray();
+    const DistributionMapping& dm = cost.DistributionMap();
+    BL_ASSERT(ba.coarsenable(blocking_factor));
+
+    BoxArray crse_ba = ba;
+    crse_ba.coarsen(blocking_factor);
+    const Box crse_domain = crse_ba.minimalBox();
+
+    //
+    // The blocks of the grids of each process are stored contiguously, in
+    // grid order, so every process knows where the costs of each grid go and
+    // only the costs themselves have to be gathered.
+    //
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int nboxes = crse_ba.size();
+    Vector<int> block_offset(nboxes);
+    Vector<int> recv_count(nprocs, 0);
+    Vector<int> recv_disp(nprocs, 0);
+    for (int i = 0; i < nboxes; ++i) {
+        recv_count[dm[i]] += crse_ba[i].numPts();
+    }
+    for (int p = 1; p < nprocs; ++p) {
+        recv_disp[p] = recv_disp[p-1] + recv_count[p-1];
+    }
+    {
+        Vector<int> pos = recv_disp;
+        for (int i = 0; i < nboxes; ++i) {
+            block_offset[i] = pos[dm[i]];
+            pos[dm[i]] += crse_ba[i].numPts();
+        }
+    }
+    const int nblocks = recv_disp[nprocs-1] + recv_count[nprocs-1];
+
+    //
+    // Sum the cost of every blocking_factor block of our grids.
+    //
+    Vector<Real> block_cost(nblocks, 0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(cost); mfi.isValid(); ++mfi) {
+        const FArrayBox& fab = cost[mfi];
+        const Box& bx = mfi.validbox();
+        const Box& cbx = crse_ba[mfi.index()];
+        Real* p = block_cost.data() + block_offset[mfi.index()];
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+            p[cbx.index(amrex::coarsen(iv, blocking_factor))] += fab(iv);
+        }
+    }
+
+#ifdef BL_USE_MPI
+    MPI_Allgatherv(MPI_IN_PLACE, 0, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                   block_cost.data(), recv_count.data(), recv_disp.data(),
+                   ParallelDescriptor::Mpi_typemap<Real>::type(),
+                   ParallelDescriptor::Communicator());
+#endif
+
+    Vector<KDTree::BlockCost> blocks;
+    blocks.reserve(nblocks);
+    for (int i = 0; i < nboxes; ++i) {
+        const Box& cbx = crse_ba[i];
+        const Real* p = block_cost.data() + block_offset[i];
+        for (IntVect iv = cbx.smallEnd(); iv <= cbx.bigEnd(); cbx.next(iv)) {
+            blocks.push_back({iv, p[cbx.index(iv)]});
+        }
+    }
+
+    KDTree tree(crse_domain, blocks, num_procs, 1);
+
+    BoxList leaves;
+    Vector<Real> leaf_costs;
+    Vector<int> leaf_procs;
+    tree.GetBoxes(leaves, leaf_costs, leaf_procs);
+
+    //
+    // Each leaf owns a contiguous range of processes.  A leaf that could not
+    // be split further owns several; its boxes go to the least loaded one.
+    //
+    BoxList bl;
+    Vector<int> pmap;
+    Vector<Real> proc_cost(num_procs, 0.0);
+    int proc_begin = 0;
+    int ileaf = 0;
+    for (const Box& leaf : leaves) {
+        const int nprocs_leaf = leaf_procs[ileaf++];
+        for (const auto& isect : crse_ba.intersections(leaf)) {
+            BoxList pieces(amrex::refine(isect.second, blocking_factor));
+            pieces.maxSize(max_grid_size);
+            const Box& cbx = crse_ba[isect.first];
+            const Real* p = block_cost.data() + block_offset[isect.first];
+            for (const Box& b : pieces) {
+                const Box& cb = amrex::coarsen(b, blocking_factor);
+                Real box_cost = 0.0;
+                for (IntVect iv = cb.smallEnd(); iv <= cb.bigEnd(); cb.next(iv)) {
+                    box_cost += p[cbx.index(iv)];
+                }
+                int proc = proc_begin;
+                for (int i = proc_begin+1; i < proc_begin+nprocs_leaf; ++i) {
+                    if (proc_cost[i] < proc_cost[proc]) proc = i;
+                }
+                proc_cost[proc] += box_cost;
+                bl.push_back(b);
+                pmap.push_back(proc);
+            }
+        }
+        proc_begin += nprocs_leaf;
+    }
+
+    new_ba.define(bl);
+    new_dm.define(pmap);
+}
+
+}
@@ -1,8 +1,18 @@
 
+#include <functional>
+
 #include <AMReX_TracerParticles.H>
 
 namespace amrex {
 
+TracerParticleContainer::~TracerParticleContainer ()
+{
+    if (HasBufferedTimestamps()) {
+        amrex::Warning("TracerParticleContainer destroyed with buffered timestamps; "
+                       "call FlushTimestamps() first or those steps are lost");
+    }
+}
+
 //
 // Uses midpoint method to advance particles using umac.
 //
@@ -222,6 +232,61 @@ TracerParticleContainer::AdvectWithUcc (const MultiFab& Ucc, int lev, Real dt)
     }
 }
 
+namespace
+{
+    //
+    // The number of files the Timestamp output is spread over.
+    //
+    int TimestampNFiles ()
+    {
+        int nOutFiles(64);
+        ParmParse pp("particles");
+        pp.query("particles_nfiles",nOutFiles);
+        if(nOutFiles == -1) {
+          nOutFiles = ParallelDescriptor::NProcs();
+        }
+        return std::max(1, std::min(nOutFiles,ParallelDescriptor::NProcs()));
+    }
+
+    //
+    // Call write on every process such that at most one process at a time
+    // writes to each of the nOutFiles files.
+    //
+    void WriteInSets (int nOutFiles, const std::function<void()>& write)
+    {
+        const int   MyProc    = ParallelDescriptor::MyProc();
+        const int   NProcs    = ParallelDescriptor::NProcs();
+        const int   nSets     = ((NProcs + (nOutFiles - 1)) / nOutFiles);
+        const int   mySet     = (MyProc / nOutFiles);
+
+        for (int iSet = 0; iSet < nSets; ++iSet)
+        {
+            if (mySet == iSet)
+            {
+                write();
+
+                const int iBuff     = 0;
+                const int wakeUpPID = (MyProc + nOutFiles);
+                const int tag       = (MyProc % nOutFiles);
+
+                if (wakeUpPID < NProcs)
+                    ParallelDescriptor::Send(&iBuff, 1, wakeUpPID, tag);
+            }
+            if (mySet == (iSet + 1))
+            {
+                //
+                // Next set waits.
+                //
+                int       iBuff;
+                const int waitForPID = (MyProc - nOutFiles);
+                const int tag        = (MyProc % nOutFiles);
+
+                ParallelDescriptor::Recv(&iBuff, 1, waitForPID, tag);
+            }
+        }
+    }
+}
+
 void
 TracerParticleContainer::Timestamp (const std::string&      basename,
 				    const MultiFab&         mf,
@@ -245,22 +310,29 @@ TracerParticleContainer::Timestamp (const std::string&      basename,
     const Real strttime = ParallelDescriptor::second();
 
     const int   MyProc    = ParallelDescriptor::MyProc();
-    const int   NProcs    = ParallelDescriptor::NProcs();
     // We'll spread the output over this many files.
-    int nOutFiles(64);
+    const int   nOutFiles = TimestampNFiles();
+
+    bool binary  = false;
+    int  nbuffer = 16;
     ParmParse pp("particles");
-    pp.query("particles_nfiles",nOutFiles);
-    if(nOutFiles == -1) {
-      nOutFiles = NProcs;
-    }
-    nOutFiles = std::max(1, std::min(nOutFiles,NProcs));
-    const int   nSets     = ((NProcs + (nOutFiles - 1)) / nOutFiles);
-    const int   mySet     = (MyProc / nOutFiles);
+    pp.query("timestamp_binary",binary);
+    pp.query("timestamp_nbuffer",nbuffer);
 
-    for (int iSet = 0; iSet < nSets; ++iSet)
+    if (binary)
+    {
+        TimestampBuffer& buf = m_timestamp_buffers[basename];
+
+        BufferTimestamp(buf, mf, lev, time, indices);
+
+        if (buf.nsteps >= nbuffer) {
+            WriteTimestampBuffer(basename, buf);
+        }
+    }
+    else
+    {
+      WriteInSets(nOutFiles, [&] ()
       {
-        if (mySet == iSet)
-	  {
             //
             // Do we have any particles at this level that need writing?
             //
@@ -349,25 +421,7 @@ TracerParticleContainer::Timestamp (const std::string&      basename,
                 TimeStampFile.flush();
                 TimeStampFile.close();
             }
-
-            const int iBuff     = 0;
-            const int wakeUpPID = (MyProc + nOutFiles);
-            const int tag       = (MyProc % nOutFiles);
-
-            if (wakeUpPID < NProcs)
-                ParallelDescriptor::Send(&iBuff, 1, wakeUpPID, tag);
-        }
-        if (mySet == (iSet + 1))
-        {
-            //
-            // Next set waits.
-            //
-            int       iBuff;
-            const int waitForPID = (MyProc - nOutFiles);
-            const int tag        = (MyProc % nOutFiles);
-
-            ParallelDescriptor::Recv(&iBuff, 1, waitForPID, tag);
-        }
+      });
     }
 
     if (m_verbose > 1)
@@ -388,4 +442,243 @@ TracerParticleContainer::Timestamp (const std::string&      basename,
     }
 }
 
+void
+TracerParticleContainer::BufferTimestamp (TimestampBuffer&        buf,
+                                          const MultiFab&         mf,
+                                          int                     lev,
+                                          Real                    time,
+                                          const std::vector<int>& indices)
+{
+    BL_PROFILE("TracerParticleContainer::BufferTimestamp()");
+
+    const int       M    = indices.size();
+    const BoxArray& ba   = mf.boxArray();
+    const Geometry& geom = m_gdb->Geom(lev);
+
+    Vector<const ParticleTileType*> tiles;
+    Vector<int> grids;
+    for (const auto& kv : GetParticles(lev)) {
+        tiles.push_back(&kv.second);
+        grids.push_back(kv.first.first);
+    }
+    const int ntiles = tiles.size();
+
+    //
+    // The particles that are written, per tile.
+    //
+    Vector<Vector<int> > which(ntiles);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < ntiles; ++t)
+    {
+        const auto& pbox = tiles[t]->GetArrayOfStructs();
+        const Box&  bx   = ba[grids[t]];
+        for (int i = 0, N = pbox.size(); i < N; ++i)
+        {
+            const ParticleType& p = pbox[i];
+
+            if (p.m_idata.id <= 0) continue;
+
+            const IntVect& iv = Index(p,lev);
+
+            if (!bx.contains(iv) && !ba.contains(iv)) continue;
+
+            which[t].push_back(i);
+        }
+    }
+
+    Vector<long> start(ntiles+1, 0);
+    for (int t = 0; t < ntiles; ++t) {
+        start[t+1] = start[t] + which[t].size();
+    }
+    const long np = start[ntiles];
+
+    const long offset = buf.data.size();
+    const long nbytes = np * (2*sizeof(int) + (2*AMREX_SPACEDIM+M)*sizeof(Real));
+
+    buf.data.resize(offset + nbytes);
+    buf.time.push_back(time);
+    buf.lev.push_back(lev);
+    buf.np.push_back(np);
+    buf.ncomp.push_back(M);
+    buf.offset.push_back(offset);
+    ++buf.nsteps;
+
+    int*  id   = (int*)  (buf.data.dataPtr() + offset);
+    int*  cpu  = id + np;
+    Real* rcol = (Real*) (cpu + np);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < ntiles; ++t)
+    {
+        const auto&      pbox = tiles[t]->GetArrayOfStructs();
+        const FArrayBox& fab  = mf[grids[t]];
+        std::vector<Real> vals(M);
+
+        for (int j = 0, N = which[t].size(); j < N; ++j)
+        {
+            const ParticleType& p = pbox[which[t][j]];
+            const long          k = start[t] + j;
+
+            id[k]  = p.m_idata.id;
+            cpu[k] = p.m_idata.cpu;
+
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                rcol[d*np + k] = p.m_rdata.pos[d];
+                //
+                // AdvectWithUmac stores the velocity in rdata ...
+                //
+                rcol[(AMREX_SPACEDIM+d)*np + k] = p.m_rdata.arr[AMREX_SPACEDIM+d];
+            }
+
+            if (M > 0)
+            {
+                ParticleType::Interp(p,geom,fab,&indices[0],&vals[0],M);
+
+                for (int i = 0; i < M; i++) {
+                    rcol[(2*AMREX_SPACEDIM+i)*np + k] = vals[i];
+                }
+            }
+        }
+    }
+}
+
+void
+TracerParticleContainer::WriteTimestampBuffer (const std::string& basename,
+                                               TimestampBuffer&   buf)
+{
+    BL_PROFILE("TracerParticleContainer::WriteTimestampBuffer()");
+
+    const int MyProc    = ParallelDescriptor::MyProc();
+    const int nOutFiles = TimestampNFiles();
+
+    WriteInSets(nOutFiles, [&] ()
+    {
+        long np_total = 0;
+        for (long np : buf.np) np_total += np;
+
+        if (np_total == 0) return;
+
+        std::string FileName = amrex::Concatenate(basename + '_', MyProc % nOutFiles, 2) + ".bin";
+        std::string IndexName = FileName + ".idx";
+
+        std::ofstream DataFile;
+        DataFile.open(FileName.c_str(), std::ios::out|std::ios::app|std::ios::binary);
+        DataFile.seekp(0, std::ios::end);
+        if (!DataFile.good())
+            amrex::FileOpenFailed(FileName);
+
+        const long base = DataFile.tellp();
+
+        DataFile.write(buf.data.dataPtr(), buf.data.size());
+        DataFile.close();
+        if (!DataFile.good())
+            amrex::Abort("TracerParticleContainer::WriteTimestampBuffer(): problem writing " + FileName);
+
+        std::ofstream IndexFile;
+        IndexFile.open(IndexName.c_str(), std::ios::out|std::ios::app);
+        IndexFile.seekp(0, std::ios::end);
+        if (!IndexFile.good())
+            amrex::FileOpenFailed(IndexName);
+
+        IndexFile.precision(17);
+
+        if (IndexFile.tellp() == 0) {
+            IndexFile << "TracerTimestamp " << AMREX_SPACEDIM << ' ' << sizeof(int) << ' ' << sizeof(Real) << '\n';
+        }
+
+        for (int i = 0, N = buf.np.size(); i < N; ++i) {
+            if (buf.np[i] == 0) continue;
+            IndexFile << buf.time[i]  << ' ' << buf.lev[i]   << ' ' << buf.np[i] << ' '
+                      << buf.ncomp[i] << ' ' << base + buf.offset[i] << '\n';
+        }
+
+        IndexFile.close();
+        if (!IndexFile.good())
+            amrex::Abort("TracerParticleContainer::WriteTimestampBuffer(): problem writing " + IndexName);
+    });
+
+    buf = TimestampBuffer();
+}
+
+void
+TracerParticleContainer::FlushTimestamps ()
+{
+    for (auto& kv : m_timestamp_buffers) {
+        if (kv.second.nsteps > 0) {
+            WriteTimestampBuffer(kv.first, kv.second);
+        }
+    }
+}
+
+bool
+TracerParticleContainer::HasBufferedTimestamps () const
+{
+    for (const auto& kv : m_timestamp_buffers) {
+        if (kv.second.nsteps > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+TracerParticleContainer::ReadTimestampFile (const std::string&       FileName,
+                                            Vector<TimestampRecord>& records)
+{
+    BL_PROFILE("TracerParticleContainer::ReadTimestampFile()");
+
+    std::string IndexName = FileName + ".idx";
+
+    std::ifstream IndexFile(IndexName.c_str());
+    if (!IndexFile.good())
+        amrex::FileOpenFailed(IndexName);
+
+    std::string magic;
+    int dim, isize, rsize;
+    IndexFile >> magic >> dim >> isize >> rsize;
+    if (magic != "TracerTimestamp" || dim != AMREX_SPACEDIM ||
+        isize != sizeof(int) || rsize != sizeof(Real))
+    {
+        amrex::Error("TracerParticleContainer::ReadTimestampFile(): incompatible file " + FileName);
+    }
+
+    std::ifstream DataFile(FileName.c_str(), std::ios::in|std::ios::binary);
+    if (!DataFile.good())
+        amrex::FileOpenFailed(FileName);
+
+    records.clear();
+
+    Real time;
+    int  lev, M;
+    long np, offset;
+    while (IndexFile >> time >> lev >> np >> M >> offset)
+    {
+        records.push_back(TimestampRecord());
+        TimestampRecord& rec = records.back();
+
+        rec.time = time;
+        rec.lev  = lev;
+        rec.id.resize(np);
+        rec.cpu.resize(np);
+        rec.pos.resize(AMREX_SPACEDIM, Vector<Real>(np));
+        rec.vel.resize(AMREX_SPACEDIM, Vector<Real>(np));
+        rec.vals.resize(M, Vector<Real>(np));
+
+        DataFile.seekg(offset, std::ios::beg);
+        DataFile.read((char*) rec.id.dataPtr(),  np*sizeof(int));
+        DataFile.read((char*) rec.cpu.dataPtr(), np*sizeof(int));
+        for (auto& col : rec.pos)  DataFile.read((char*) col.dataPtr(), np*sizeof(Real));
+        for (auto& col : rec.vel)  DataFile.read((char*) col.dataPtr(), np*sizeof(Real));
+        for (auto& col : rec.vals) DataFile.read((char*) col.dataPtr(), np*sizeof(Real));
+
+        if (!DataFile.good())
+            amrex::Error("TracerParticleContainer::ReadTimestampFile(): problem reading " + FileName);
+    }
+}
+
 }
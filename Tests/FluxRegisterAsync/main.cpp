@@ -0,0 +1,196 @@
+//
+// Fills FluxRegisters with non-constant coarse and fine fluxes and checks
+// that CrseInit_nowait/CrseInit_finish give the same registers as the
+// FabSet copies CrseInit used to do, and that Reflux_nowait/Reflux_finish,
+// with work on the registers in between, give the same result as Reflux.
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FluxRegister.H>
+
+using namespace amrex;
+
+namespace {
+
+const int nflux = 3;
+const int scomp = 1;
+const int ncomp = 2;
+
+void
+init_flux (MultiFab& flux, int dir, Real shift)
+{
+    for (MFIter mfi(flux); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = flux[mfi];
+        const Box& bx = mfi.validbox();
+        for (int n = 0; n < nflux; ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                fab(iv,n) = std::sin(0.3*iv[0] + 0.7*iv[1] + 1.1*iv[2] + dir + n + shift)
+                    + 0.01*(iv[0]*iv[1] - iv[2]);
+            }
+        }
+    }
+}
+
+//
+// The registers of dir as CrseInit filled them before CrseInit_nowait.
+//
+void
+crse_init_ref (FluxRegister& fr, const MultiFab& mflx, int dir, Real mult,
+               FluxRegister::FrOp op)
+{
+    MultiFab mf(mflx.boxArray(), mflx.DistributionMap(), ncomp, 0);
+    MultiFab::Copy(mf, mflx, scomp, 0, ncomp, 0);
+    mf.mult(mult);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const Orientation face(dir, pass == 0 ? Orientation::low : Orientation::high);
+        if (op == FluxRegister::COPY)
+        {
+            fr[face].copyFrom(mf,0,0,0,ncomp);
+        }
+        else
+        {
+            FabSet fs(fr[face].boxArray(),fr[face].DistributionMap(),ncomp);
+            fs.setVal(0);
+            fs.copyFrom(mf,0,0,0,ncomp);
+            for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
+                fr[face][mfi].plus(fs[mfi],0,0,ncomp);
+        }
+    }
+}
+
+Real
+register_diff (const FluxRegister& a, const FluxRegister& b)
+{
+    Real diff = 0.0;
+    for (OrientationIter fi; fi; ++fi)
+    {
+        const Orientation face = fi();
+        for (FabSetIter fsi(a[face]); fsi.isValid(); ++fsi)
+        {
+            FArrayBox d(a[face][fsi].box(), ncomp);
+            d.copy(a[face][fsi]);
+            d.minus(b[face][fsi]);
+            diff = std::max(diff, d.norm(0,0,ncomp));
+        }
+    }
+    ParallelDescriptor::ReduceRealMax(diff);
+    return diff;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    int ierr = 0;
+    {
+        ParmParse pp;
+        int n_cell = 64, max_grid_size = 16, fine_max_grid_size = 16;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("fine_max_grid_size", fine_max_grid_size);
+
+        const Box domain(IntVect(AMREX_D_DECL(0,0,0)),
+                         IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        int is_per[] = {AMREX_D_DECL(1,1,1)};
+        Geometry geom(domain, &rb, 0, is_per);
+
+        BoxArray cba(domain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        const IntVect ratio(AMREX_D_DECL(2,2,2));
+        Box fdomain = domain;
+        fdomain.setBig(0, n_cell/2-1);
+        fdomain.setBig(1, n_cell/2-1);
+        BoxArray fba(amrex::refine(fdomain, ratio));
+        fba.maxSize(fine_max_grid_size);
+        DistributionMapping fdm(fba);
+
+        MultiFab cflux[AMREX_SPACEDIM], fflux[AMREX_SPACEDIM];
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+        {
+            const IntVect typ = IntVect::TheDimensionVector(dir);
+            cflux[dir].define(amrex::convert(cba,typ), cdm, nflux, 0);
+            fflux[dir].define(amrex::convert(fba,typ), fdm, nflux, 0);
+            init_flux(cflux[dir], dir, 0.0);
+            init_flux(fflux[dir], dir, 0.5);
+        }
+
+        //
+        // CrseInit against the FabSet copies, for COPY and then ADD.
+        //
+        FluxRegister fr_ref(fba, fdm, ratio, 1, ncomp);
+        FluxRegister fr    (fba, fdm, ratio, 1, ncomp);
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            crse_init_ref(fr_ref, cflux[dir], dir, -1.0, FluxRegister::COPY);
+            fr.CrseInit_nowait(cflux[dir], dir, scomp, 0, ncomp, -1.0, FluxRegister::COPY);
+        }
+        fr.CrseInit_finish();
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            crse_init_ref(fr_ref, cflux[dir], dir, 0.25, FluxRegister::ADD);
+            fr.CrseInit_nowait(cflux[dir], dir, scomp, 0, ncomp, 0.25, FluxRegister::ADD);
+        }
+        fr.CrseInit_finish();
+
+        const Real crse_init_diff = register_diff(fr, fr_ref);
+        amrex::Print() << "CrseInit_nowait vs FabSet copies, max diff: " << crse_init_diff << "\n";
+        if (crse_init_diff != 0.0) ierr = 1;
+
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            fr_ref.FineAdd(fflux[dir], dir, scomp, 0, ncomp, 0.125);
+            fr    .FineAdd(fflux[dir], dir, scomp, 0, ncomp, 0.125);
+        }
+
+        //
+        // Blocking Reflux against Reflux_nowait with the registers reset
+        // and refilled for a next step before Reflux_finish.
+        //
+        MultiFab state_ref(cba, cdm, ncomp, 0);
+        MultiFab state    (cba, cdm, ncomp, 0);
+        state_ref.setVal(1.0);
+        state    .setVal(1.0);
+
+        fr_ref.Reflux(state_ref, 1.0, 0, 0, ncomp, geom);
+
+        fr.Reflux_nowait(state, 1.0, 0, 0, ncomp, geom);
+        if (!fr.RefluxPending()) ierr = 1;
+        fr.setVal(0.0);
+        for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+            init_flux(fflux[dir], dir, 1.0);
+            fr.FineAdd(fflux[dir], dir, scomp, 0, ncomp, 0.125);
+        }
+        fr.Reflux_finish();
+
+        MultiFab::Subtract(state, state_ref, 0, 0, ncomp, 0);
+        state_ref.plus(-1.0, 0, ncomp, 0);
+        Real reflux_diff = 0.0, reflux_corr = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            reflux_diff = std::max(reflux_diff, state.norm0(n));
+            reflux_corr = std::max(reflux_corr, state_ref.norm0(n));
+        }
+        amrex::Print() << "Reflux_nowait vs Reflux, max diff: " << reflux_diff
+                       << " (max correction " << reflux_corr << ")\n";
+        if (reflux_diff != 0.0 || reflux_corr == 0.0) ierr = 1;
+    }
+
+    if (ierr) {
+        amrex::Abort("FluxRegisterAsync: the nonblocking and blocking results differ");
+    }
+    amrex::Print() << "PASSED\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,125 @@
+//
+// Compares the ratio-specialized C++ kernels of NodeBilinear and
+// CellConservativeLinear with the Fortran ones, for refinement ratios of
+// 2 and 4.
+//
+
+#include <cmath>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_BCRec.H>
+#include <AMReX_BC_TYPES.H>
+#include <AMReX_Interpolater.H>
+
+using namespace amrex;
+
+namespace {
+
+void
+init_crse (FArrayBox& fab, int ncomp)
+{
+    const Box& bx = fab.box();
+    for (int n = 0; n < ncomp; ++n) {
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+            const Real x = iv[0]*0.11, y = iv[1]*0.07, z = iv[2]*0.05;
+            // Smooth with a few steps so that the limiters have work to do.
+            Real v = std::sin(x+n)*std::cos(y) + z*z;
+            if ((iv[0]+iv[1]+iv[2]) % 7 == 0) v += 1.0;
+            fab(iv,n) = v;
+        }
+    }
+}
+
+Real
+run (Interpolater& interp, bool specialize, const FArrayBox& crse, FArrayBox& fine,
+     int ncomp, const Box& fine_region, int ratio, const Geometry& cgeom,
+     const Geometry& fgeom, Vector<BCRec>& bcr, int nreps)
+{
+    Interpolater::specialize_ratio = specialize;
+    const Real t0 = ParallelDescriptor::second();
+    for (int i = 0; i < nreps; ++i) {
+        interp.interp(crse,0,fine,0,ncomp,fine_region,IntVect(ratio),
+                      cgeom,fgeom,bcr,0,0);
+    }
+    return (ParallelDescriptor::second() - t0) / nreps;
+}
+
+void
+compare (const std::string& name, Interpolater& interp, bool nodal, int ratio,
+         int n_cell, int ncomp, int nreps)
+{
+    const Box cdomain(IntVect(0), IntVect(n_cell-1));
+    const Box fdomain = amrex::refine(cdomain, ratio);
+
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    int is_per[AMREX_SPACEDIM] = {AMREX_D_DECL(0,0,0)};
+    Geometry cgeom(cdomain, &rb, 0, is_per);
+    Geometry fgeom(fdomain, &rb, 0, is_per);
+
+    // Interpolate onto the whole fine domain, with physical boundaries on
+    // the low sides.
+    Box fine_region = nodal ? amrex::surroundingNodes(fdomain) : fdomain;
+    Box crse_box    = interp.CoarseBox(fine_region, ratio);
+
+    FArrayBox crse(crse_box, ncomp);
+    init_crse(crse, ncomp);
+
+    FArrayBox fine_f(fine_region, ncomp);
+    FArrayBox fine_c(fine_region, ncomp);
+    fine_f.setVal(0.0);
+    fine_c.setVal(0.0);
+
+    Vector<BCRec> bcr(ncomp, BCRec(AMREX_D_DECL(EXT_DIR,HOEXTRAP,EXT_DIR),
+                                   AMREX_D_DECL(INT_DIR,INT_DIR,FOEXTRAP)));
+
+    const Real tf = run(interp, false, crse, fine_f, ncomp, fine_region, ratio,
+                        cgeom, fgeom, bcr, nreps);
+    const Real tc = run(interp, true, crse, fine_c, ncomp, fine_region, ratio,
+                        cgeom, fgeom, bcr, nreps);
+
+    Real maxval = fine_f.norm(0, 0, ncomp);
+    fine_c.minus(fine_f, 0, 0, ncomp);
+    Real maxdiff = fine_c.norm(0, 0, ncomp);
+
+    amrex::Print() << name << " ratio " << ratio
+                   << ": Fortran " << tf << " s, C++ " << tc << " s, speedup "
+                   << tf/tc << ", max rel diff " << maxdiff/maxval << "\n";
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        int ncomp  = 4;
+        int nreps  = 20;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("ncomp", ncomp);
+            pp.query("nreps", nreps);
+        }
+
+        const bool save = Interpolater::specialize_ratio;
+
+        for (int ratio = 2; ratio <= 4; ratio += 2) {
+            compare("node_bilinear_interp", node_bilinear_interp, true,
+                    ratio, n_cell, ncomp, nreps);
+            compare("cell_cons_interp    ", cell_cons_interp, false,
+                    ratio, n_cell, ncomp, nreps);
+            compare("lincc_interp        ", lincc_interp, false,
+                    ratio, n_cell, ncomp, nreps);
+        }
+
+        Interpolater::specialize_ratio = save;
+    }
+    amrex::Finalize();
+}
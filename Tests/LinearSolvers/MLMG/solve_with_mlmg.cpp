@@ -19,6 +19,14 @@ namespace {
     static int linop_maxorder = 2;
     static bool agglomeration = false;
     static bool consolidation = false;
+    static bool stencil_cache = false;
+    static std::string stencil_precision = "full";
+    static bool fused_restriction = true;
+    static std::string smoother = "gsrb";
+    static int smoother_degree = 2;
+    static int num_solves = 1;
+    static std::string krylov = "none";
+    static int krylov_restart = 10;
 }
 
 void solve_with_mlmg (const Vector<Geometry>& geom, int ref_ratio,
@@ -39,6 +47,41 @@ void solve_with_mlmg (const Vector<Geometry>& geom, int ref_ratio,
         pp.query("linop_maxorder", linop_maxorder);
         pp.query("agglomeration", agglomeration);
         pp.query("consolidation", consolidation);
+        pp.query("stencil_cache", stencil_cache);
+        pp.query("stencil_precision", stencil_precision);
+        pp.query("fused_restriction", fused_restriction);
+        pp.query("smoother", smoother);
+        pp.query("smoother_degree", smoother_degree);
+        pp.query("num_solves", num_solves);
+        pp.query("krylov", krylov);
+        pp.query("krylov_restart", krylov_restart);
+    }
+
+    MLLinOp::Smoother smoother_type = MLLinOp::Smoother::gsrb;
+    if (smoother == "l1jacobi") {
+        smoother_type = MLLinOp::Smoother::l1jacobi;
+    } else if (smoother == "chebyshev") {
+        smoother_type = MLLinOp::Smoother::chebyshev;
+    } else if (smoother != "gsrb") {
+        amrex::Abort("solve_with_mlmg: unknown smoother " + smoother);
+    }
+
+    MLMG::Krylov krylov_type = MLMG::Krylov::none;
+    if (krylov == "fcg") {
+        krylov_type = MLMG::Krylov::fcg;
+    } else if (krylov == "fgmres") {
+        krylov_type = MLMG::Krylov::fgmres;
+    } else if (krylov != "none") {
+        amrex::Abort("solve_with_mlmg: unknown krylov " + krylov);
+    }
+
+    MLABecLaplacian::StencilPrecision stencil_precision_type = MLABecLaplacian::StencilPrecision::full;
+    if (stencil_precision == "single_coarse") {
+        stencil_precision_type = MLABecLaplacian::StencilPrecision::single_coarse;
+    } else if (stencil_precision == "single_cycle") {
+        stencil_precision_type = MLABecLaplacian::StencilPrecision::single_cycle;
+    } else if (stencil_precision != "full") {
+        amrex::Abort("solve_with_mlmg: unknown stencil_precision " + stencil_precision);
     }
 
     LPInfo info;
@@ -69,40 +112,75 @@ void solve_with_mlmg (const Vector<Geometry>& geom, int ref_ratio,
         MLABecLaplacian mlabec(geom, grids, dmap, info);
 
         mlabec.setMaxOrder(linop_maxorder);
+        mlabec.setStencilCache(stencil_cache);
+        mlabec.setStencilPrecision(stencil_precision_type);
+        mlabec.setSmoother(smoother_type);
+        mlabec.setSmootherDegree(smoother_degree);
         
         // BC
         mlabec.setDomainBC({prob::bc_type,prob::bc_type,prob::bc_type},
                            {prob::bc_type,prob::bc_type,prob::bc_type});
-        for (int ilev = 0; ilev < nlevels; ++ilev) {
-            mlabec.setLevelBC(ilev, psoln[ilev]);
-        }
-        
-        mlabec.setScalars(prob::a, prob::b);
-        for (int ilev = 0; ilev < nlevels; ++ilev)
+
+        auto set_bc_and_coeffs = [&] ()
         {
-            mlabec.setACoeffs(ilev, alpha[ilev]);
-            
-            std::array<MultiFab,AMREX_SPACEDIM> bcoefs;
-            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            for (int ilev = 0; ilev < nlevels; ++ilev) {
+                mlabec.setLevelBC(ilev, psoln[ilev]);
+            }
+
+            mlabec.setScalars(prob::a, prob::b);
+            for (int ilev = 0; ilev < nlevels; ++ilev)
             {
-                const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
-                                                    IntVect::TheDimensionVector(idim));
-                bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+                mlabec.setACoeffs(ilev, alpha[ilev]);
+
+                std::array<MultiFab,AMREX_SPACEDIM> bcoefs;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+                {
+                    const BoxArray& ba = amrex::convert(beta[ilev].boxArray(),
+                                                        IntVect::TheDimensionVector(idim));
+                    bcoefs[idim].define(ba, beta[ilev].DistributionMap(), 1, 0);
+                }
+                amrex::average_cellcenter_to_face({AMREX_D_DECL(&bcoefs[0],
+                                                                &bcoefs[1],
+                                                                &bcoefs[2])},
+                                                   beta[ilev], geom[ilev]);
+                mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
             }
-            amrex::average_cellcenter_to_face({AMREX_D_DECL(&bcoefs[0],
-                                                            &bcoefs[1],
-                                                            &bcoefs[2])},
-                                               beta[ilev], geom[ilev]);
-            mlabec.setBCoeffs(ilev, amrex::GetArrOfConstPtrs(bcoefs));
+        };
+
+        // The solve overwrites the ghost cells holding the bc data.
+        Vector<MultiFab> soln0(num_solves > 1 ? nlevels : 0);
+        for (int ilev = 0; ilev < int(soln0.size()); ++ilev) {
+            soln0[ilev].define(soln[ilev].boxArray(), soln[ilev].DistributionMap(), 1, 1);
+            MultiFab::Copy(soln0[ilev], soln[ilev], 0, 0, 1, 1);
         }
-        
+
+        set_bc_and_coeffs();
+
         MLMG mlmg(mlabec);
         mlmg.setMaxIter(max_iter);
         mlmg.setMaxFmgIter(max_fmg_iter);
         mlmg.setVerbose(verbose);
         mlmg.setCGVerbose(cg_verbose);
+        mlmg.setFusedResRestriction(fused_restriction);
+        mlmg.setKrylov(krylov_type);
+        mlmg.setKrylovRestart(krylov_restart);
         
         mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+
+        // Repeat the solve from scratch, reusing the operator and MLMG
+        // setup as a time stepping code would.
+        for (int isolve = 1; isolve < num_solves; ++isolve)
+        {
+            if (!mlabec.rebind(grids, dmap)) {
+                amrex::Abort("solve_with_mlmg: rebind failed on unchanged grids");
+            }
+            for (int ilev = 0; ilev < nlevels; ++ilev) {
+                MultiFab::Copy(soln[ilev], soln0[ilev], 0, 0, 1, 1);
+            }
+            set_bc_and_coeffs();
+
+            mlmg.solve(psoln, prhs, tol_rel, tol_abs);
+        }
     }
     else
     {
@@ -119,6 +197,10 @@ void solve_with_mlmg (const Vector<Geometry>& geom, int ref_ratio,
                                    {soln[ilev].DistributionMap()});
 
             mlabec.setMaxOrder(linop_maxorder);
+            mlabec.setStencilCache(stencil_cache);
+            mlabec.setStencilPrecision(stencil_precision_type);
+            mlabec.setSmoother(smoother_type);
+            mlabec.setSmootherDegree(smoother_degree);
 
             mlabec.setDomainBC({prob::bc_type,prob::bc_type,prob::bc_type},
                                {prob::bc_type,prob::bc_type,prob::bc_type});
@@ -150,6 +232,9 @@ void solve_with_mlmg (const Vector<Geometry>& geom, int ref_ratio,
             mlmg.setMaxFmgIter(max_fmg_iter);
             mlmg.setVerbose(verbose);
             mlmg.setCGVerbose(cg_verbose);
+            mlmg.setFusedResRestriction(fused_restriction);
+            mlmg.setKrylov(krylov_type);
+            mlmg.setKrylovRestart(krylov_restart);
         
             mlmg.solve({&soln[ilev]}, {&rhs[ilev]}, tol_rel, tol_abs);
         }
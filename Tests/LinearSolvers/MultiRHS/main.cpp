@@ -0,0 +1,194 @@
+//
+// Blocked multi right-hand side solve with MLMG.  ncomp right-hand sides of
+// different shape and size are solved together with a multi-component
+// MLABecLaplacian, once with each of the bicgstab and cg bottom solvers, and
+// every component is compared against a single-component solve of the same
+// right-hand side.  With krylov = 1 or 2 the MLMG cycle is used as the
+// preconditioner of flexible CG or GMRES.
+//
+
+#include <cmath>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+using namespace amrex;
+
+namespace {
+
+void init_coeffs (const Geometry& geom, MultiFab& acoef, MultiFab& bcoef, MultiFab& rhs)
+{
+    const Real* dx = geom.CellSize();
+    const Real* plo = geom.ProbLo();
+    const Real pi = 4.0*std::atan(1.0);
+    const int ncomp = rhs.nComp();
+
+    for (MFIter mfi(bcoef); mfi.isValid(); ++mfi)
+    {
+        const Box& gbx = mfi.fabbox();
+        const Box& vbx = mfi.validbox();
+        FArrayBox& bfab = bcoef[mfi];
+        FArrayBox& afab = acoef[mfi];
+        FArrayBox& rfab = rhs[mfi];
+        for (IntVect iv = gbx.smallEnd(); iv <= gbx.bigEnd(); gbx.next(iv))
+        {
+            Real x[AMREX_SPACEDIM];
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                x[d] = plo[d] + (iv[d]+0.5)*dx[d];
+            }
+            Real r2 = 0.0;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                r2 += (x[d]-0.5)*(x[d]-0.5);
+            }
+            bfab(iv) = 1.0 + 0.9*std::tanh((0.1-std::sqrt(r2))/0.05);
+            if (vbx.contains(iv))
+            {
+                afab(iv) = 1.0;
+                // Component n has frequency n+1 and magnitude 10^n, so the
+                // components converge at different rates.
+                for (int n = 0; n < ncomp; ++n)
+                {
+                    Real f = std::pow(10.0, n);
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                        f *= std::sin(2.0*pi*(n+1)*x[d]) + 0.5*std::cos(6.0*pi*x[d]);
+                    }
+                    rfab(iv,n) = f;
+                }
+            }
+        }
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int ncomp = 3;
+        int bc_type = 0;
+        Real tol_rel = 1.e-10;
+        Real check_tol = 1.e-8;
+        int krylov = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("bc_type", bc_type);
+            pp.query("tol_rel", tol_rel);
+            pp.query("check_tol", check_tol);
+            pp.query("krylov", krylov);
+        }
+
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)),
+                   IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        RealBox real_box({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        std::array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        MLLinOp::BCType bct = MLLinOp::BCType::Dirichlet;
+        if (bc_type == 1) {
+            bct = MLLinOp::BCType::Neumann;
+        } else if (bc_type == 2) {
+            bct = MLLinOp::BCType::Periodic;
+            std::fill(is_periodic.begin(), is_periodic.end(), 1);
+        }
+        Geometry geom(domain, &real_box, 0, is_periodic.data());
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab acoef(ba, dm, 1, 0);
+        MultiFab bcc  (ba, dm, 1, 1);
+        MultiFab rhs  (ba, dm, ncomp, 0);
+        init_coeffs(geom, acoef, bcc, rhs);
+
+        std::array<MultiFab,AMREX_SPACEDIM> bcoef;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bcoef[idim].define(amrex::convert(ba,IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+        amrex::average_cellcenter_to_face({AMREX_D_DECL(&bcoef[0],&bcoef[1],&bcoef[2])}, bcc, geom);
+
+        const Real ascalar = (bc_type == 0) ? 1.e-3 : 0.0;
+
+        auto do_solve = [&] (MultiFab& soln, const MultiFab& b, MLMG::BottomSolver bottom) -> Real
+        {
+            const int nc = soln.nComp();
+            LPInfo info;
+            MLABecLaplacian mlabec({geom}, {ba}, {dm}, info, {}, nc);
+            mlabec.setMaxOrder(2);
+            mlabec.setDomainBC({AMREX_D_DECL(bct,bct,bct)}, {AMREX_D_DECL(bct,bct,bct)});
+            mlabec.setLevelBC(0, &soln);
+            mlabec.setScalars(ascalar, 1.0);
+            mlabec.setACoeffs(0, acoef);
+            mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+
+            MLMG mlmg(mlabec);
+            mlmg.setVerbose(1);
+            mlmg.setBottomSolver(bottom);
+            mlmg.setKrylov(static_cast<MLMG::Krylov>(krylov));
+
+            const Real t0 = amrex::second();
+            mlmg.solve({&soln}, {&b}, tol_rel, 0.0);
+            Real t1 = amrex::second() - t0;
+            ParallelDescriptor::ReduceRealMax(t1);
+            return t1;
+        };
+
+        const Vector<std::pair<MLMG::BottomSolver,std::string> > solvers {
+            {MLMG::BottomSolver::bicgstab, "bicgstab"},
+            {MLMG::BottomSolver::cg,       "cg"}};
+
+        bool failed = false;
+
+        for (const auto& s : solvers)
+        {
+            amrex::Print() << "\nBlocked solve of " << ncomp << " right-hand sides, bottom solver "
+                           << s.second << "\n";
+            MultiFab soln(ba, dm, ncomp, 1);
+            soln.setVal(0.0);
+            const Real tblock = do_solve(soln, rhs, s.first);
+
+            Real tsingle = 0.0;
+            for (int n = 0; n < ncomp; ++n)
+            {
+                amrex::Print() << "\nSingle solve of right-hand side " << n << "\n";
+                MultiFab b1(ba, dm, 1, 0);
+                MultiFab x1(ba, dm, 1, 1);
+                MultiFab::Copy(b1, rhs, n, 0, 1, 0);
+                x1.setVal(0.0);
+                tsingle += do_solve(x1, b1, s.first);
+
+                const Real refnorm = x1.norm0();
+                MultiFab::Subtract(x1, soln, n, 0, 1, 0);
+                if (bc_type != 0) {
+                    x1.plus(-x1.sum(0) / domain.d_numPts(), 0, 1, 0);
+                }
+                const Real diff = x1.norm0(0,0) / refnorm;
+                amrex::Print() << "    component " << n << ": rel. diff. from single solve "
+                               << diff << "\n";
+                if (diff > check_tol) {
+                    amrex::Print() << "    component " << n << " FAILED\n";
+                    failed = true;
+                }
+            }
+
+            amrex::Print() << "    " << s.second << ": blocked solve time " << tblock
+                           << ", one-at-a-time solve time " << tsingle << "\n";
+        }
+
+        if (failed) {
+            amrex::Abort("Blocked and single right-hand side solves do not agree");
+        }
+        amrex::Print() << "\nBlocked and single right-hand side solves agree\n";
+    }
+
+    amrex::Finalize();
+}
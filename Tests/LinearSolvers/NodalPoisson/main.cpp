@@ -0,0 +1,158 @@
+//
+// Nodal Poisson solve with MLNodeLaplacian and a variable sigma.  The
+// problem is solved with the halo exchange overlapped with the interior of
+// apply and smooth, with the compact stencil cache, and with both, and each
+// solution is compared against a solve that uses neither.
+//
+
+#include <cmath>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLNodeLaplacian.H>
+#include <AMReX_MLMG.H>
+
+using namespace amrex;
+
+namespace {
+
+void init_data (const Geometry& geom, MultiFab& sigma, MultiFab& rhs)
+{
+    const Real* dx = geom.CellSize();
+    const Real* plo = geom.ProbLo();
+    const Real pi = 4.0*std::atan(1.0);
+
+    for (MFIter mfi(sigma); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        FArrayBox& sfab = sigma[mfi];
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+        {
+            Real r2 = 0.0;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                const Real x = plo[d] + (iv[d]+0.5)*dx[d];
+                r2 += (x-0.5)*(x-0.5);
+            }
+            sfab(iv) = 1.0 + 0.9*std::tanh((0.1-std::sqrt(r2))/0.05);
+        }
+    }
+
+    for (MFIter mfi(rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        FArrayBox& rfab = rhs[mfi];
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+        {
+            // Zero mean over the nodes, so that the periodic problem is
+            // solvable.
+            Real f = 1.0;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                const Real x = plo[d] + iv[d]*dx[d];
+                f *= std::cos(2.0*pi*x) + 0.5*std::cos(6.0*pi*x);
+            }
+            rfab(iv) = f;
+        }
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int bc_type = 0;
+        Real tol_rel = 1.e-10;
+        Real check_tol = 1.e-8;
+        int gauss_seidel = 1;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("bc_type", bc_type);
+            pp.query("tol_rel", tol_rel);
+            pp.query("check_tol", check_tol);
+            pp.query("gauss_seidel", gauss_seidel);
+        }
+
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)),
+                   IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        RealBox real_box({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        std::array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        MLLinOp::BCType bct = MLLinOp::BCType::Dirichlet;
+        if (bc_type == 1) {
+            bct = MLLinOp::BCType::Periodic;
+            std::fill(is_periodic.begin(), is_periodic.end(), 1);
+        }
+        Geometry geom(domain, &real_box, 0, is_periodic.data());
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const BoxArray& nba = amrex::convert(ba, IntVect::TheNodeVector());
+
+        MultiFab sigma(ba, dm, 1, 0);
+        MultiFab rhs(nba, dm, 1, 0);
+        init_data(geom, sigma, rhs);
+
+        auto do_solve = [&] (MultiFab& soln, bool overlap, bool cache) -> Real
+        {
+            MLNodeLaplacian linop({geom}, {ba}, {dm});
+            linop.setDomainBC({AMREX_D_DECL(bct,bct,bct)}, {AMREX_D_DECL(bct,bct,bct)});
+            linop.setGaussSeidel(gauss_seidel);
+            linop.setOverlapHaloExchange(overlap);
+            linop.setStencilCache(cache);
+            linop.setSigma(0, sigma);
+
+            MLMG mlmg(linop);
+            mlmg.setVerbose(1);
+
+            soln.setVal(0.0);
+            const Real t0 = amrex::second();
+            mlmg.solve({&soln}, {&rhs}, tol_rel, 0.0);
+            Real t1 = amrex::second() - t0;
+            ParallelDescriptor::ReduceRealMax(t1);
+            return t1;
+        };
+
+        amrex::Print() << "\nReference solve\n";
+        MultiFab ref(nba, dm, 1, 1);
+        const Real tref = do_solve(ref, false, false);
+        const Real refnorm = ref.norm0();
+
+        const Vector<std::pair<bool,bool> > variants {{true,false}, {false,true}, {true,true}};
+
+        bool failed = false;
+
+        for (const auto& v : variants)
+        {
+            amrex::Print() << "\nSolve with overlap_halo = " << v.first
+                           << ", stencil_cache = " << v.second << "\n";
+            MultiFab soln(nba, dm, 1, 1);
+            const Real t = do_solve(soln, v.first, v.second);
+
+            MultiFab::Subtract(soln, ref, 0, 0, 1, 0);
+            if (bc_type != 0) {
+                soln.plus(-soln.sum(0) / nba.d_numPts(), 0, 1, 0);
+            }
+            const Real diff = soln.norm0(0,0) / refnorm;
+            amrex::Print() << "    rel. diff. from reference " << diff
+                           << ", solve time " << t << " (reference " << tref << ")\n";
+            if (diff > check_tol) {
+                amrex::Print() << "    FAILED\n";
+                failed = true;
+            }
+        }
+
+        if (failed) {
+            amrex::Abort("Nodal solves do not agree with the reference solve");
+        }
+        amrex::Print() << "\nAll nodal solves agree with the reference solve\n";
+    }
+
+    amrex::Finalize();
+}
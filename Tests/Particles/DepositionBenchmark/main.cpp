@@ -0,0 +1,199 @@
+#include <cmath>
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include "AMReX_Particles.H"
+
+using namespace amrex;
+
+//
+// Compares the Fortran AoS deposition/interpolation kernels with the
+// batched struct-of-arrays kernels in AMReX_ParticleMeshKernels.H, on
+// particles with varying weights and on a varying field.
+//
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+  {
+    ParmParse pp;
+
+    int nx, ny, nz, max_grid_size, nppc;
+    int nsteps = 10;
+    pp.get("nx", nx);
+    pp.get("ny", ny);
+    pp.get("nz", nz);
+    pp.get("max_grid_size", max_grid_size);
+    pp.get("nppc", nppc);
+    pp.query("nsteps", nsteps);
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++) {
+      real_box.setLo(n, 0.0);
+      real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(nx-1,ny-1,nz-1)));
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++) is_per[i] = 1;
+    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dmap(ba);
+
+    typedef ParticleContainer<1 + BL_SPACEDIM> MyParticleContainer;
+    MyParticleContainer myPC(geom, dmap, ba);
+
+    long num_particles = long(nppc) * domain.numPts();
+    amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+    MyParticleContainer::ParticleInitData pdata = {1.0, 1.0, 2.0, 3.0};
+    myPC.InitRandom(num_particles, 451, pdata, true);
+
+    const int ncomp = 1 + BL_SPACEDIM;
+    const Real tol = 1.e-12;
+    bool passed = true;
+
+    using MyParIter = ParIter<1 + BL_SPACEDIM>;
+    for (MyParIter pti(myPC, 0); pti.isValid(); ++pti) {
+      for (auto& p : pti.GetArrayOfStructs()) {
+        for (int n = 0; n < ncomp; ++n) {
+          p.rdata(n) = 1.0 + 0.5*std::sin(2.0*M_PI*p.pos(n % BL_SPACEDIM) + n);
+        }
+      }
+    }
+    MultiFab rho_fort(ba, dmap, ncomp, 1);
+    MultiFab rho_soa (ba, dmap, ncomp, 1);
+
+    Real t0 = ParallelDescriptor::second();
+    for (int i = 0; i < nsteps; ++i) {
+      rho_fort.setVal(0.0);
+      myPC.AssignCellDensitySingleLevelFort(0, rho_fort, 0, ncomp);
+    }
+    Real t_fort = (ParallelDescriptor::second() - t0) / nsteps;
+
+    t0 = ParallelDescriptor::second();
+    for (int i = 0; i < nsteps; ++i) {
+      myPC.AssignCellDensitySingleLevelSoA(0, rho_soa, 0, ncomp, ParticleMesh::CIC);
+    }
+    Real t_soa = (ParallelDescriptor::second() - t0) / nsteps;
+
+    ParallelDescriptor::ReduceRealMax(t_fort);
+    ParallelDescriptor::ReduceRealMax(t_soa);
+
+    MultiFab::Subtract(rho_soa, rho_fort, 0, 0, ncomp, 0);
+    Real diff = 0.0;
+    for (int n = 0; n < ncomp; ++n) {
+      diff = std::max(diff, rho_soa.norm0(n) / rho_fort.norm0(n));
+    }
+    passed = passed && diff < tol;
+
+    amrex::Print() << "CIC deposition   Fortran: " << t_fort << " s, SoA: " << t_soa
+                   << " s, max rel. difference: " << diff << "\n";
+
+    for (int shape : {ParticleMesh::NGP, ParticleMesh::TSC}) {
+      t0 = ParallelDescriptor::second();
+      for (int i = 0; i < nsteps; ++i) {
+        myPC.AssignCellDensitySingleLevelSoA(0, rho_soa, 0, 1, shape);
+      }
+      Real t = (ParallelDescriptor::second() - t0) / nsteps;
+      ParallelDescriptor::ReduceRealMax(t);
+      const Real mass = rho_soa.sum(0) * AMREX_D_TERM(geom.CellSize(0),*geom.CellSize(1),*geom.CellSize(2));
+      amrex::Print() << (shape == ParticleMesh::NGP ? "NGP" : "TSC")
+                     << " deposition   SoA: " << t << " s, total mass: " << mass << "\n";
+    }
+
+    // The Fortran kernel only checks that it interpolates 5 and does not
+    // store the result, so it is timed on a constant field.
+    MultiFab acceleration(ba, dmap, BL_SPACEDIM, 1);
+    acceleration.setVal(5.0, 1);
+
+    t0 = ParallelDescriptor::second();
+    for (int i = 0; i < nsteps; ++i) {
+      myPC.InterpolateSingleLevelFort(acceleration, 0);
+    }
+    t_fort = (ParallelDescriptor::second() - t0) / nsteps;
+
+    t0 = ParallelDescriptor::second();
+    for (int i = 0; i < nsteps; ++i) {
+      myPC.InterpolateSingleLevelSoA(acceleration, 0, 1, ParticleMesh::CIC);
+    }
+    t_soa = (ParallelDescriptor::second() - t0) / nsteps;
+
+    ParallelDescriptor::ReduceRealMax(t_fort);
+    ParallelDescriptor::ReduceRealMax(t_soa);
+
+    Real err = 0.0;
+    for (const auto& kv : myPC.GetParticles(0)) {
+      for (const auto& p : kv.second.GetArrayOfStructs()) {
+        for (int n = 0; n < BL_SPACEDIM; ++n) {
+          err = std::max(err, std::abs(p.rdata(1+n) - 5.0));
+        }
+      }
+    }
+    ParallelDescriptor::ReduceRealMax(err);
+    passed = passed && err < tol;
+
+    amrex::Print() << "CIC interpolation Fortran: " << t_fort << " s, SoA: " << t_soa
+                   << " s, max error: " << err << "\n";
+
+    // A periodic field, checked against the weights of the Fortran kernel.
+    const Real* dx = geom.CellSize();
+    for (MFIter mfi(acceleration); mfi.isValid(); ++mfi) {
+      FArrayBox& fab = acceleration[mfi];
+      const Box& bx = mfi.validbox();
+      for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+        for (int n = 0; n < BL_SPACEDIM; ++n) {
+          Real v = n;
+          for (int d = 0; d < BL_SPACEDIM; ++d) {
+            v += std::sin(2.0*M_PI*(iv[d]+0.5)*dx[d] + d*(n+1));
+          }
+          fab(iv,n) = v;
+        }
+      }
+    }
+    acceleration.FillBoundary(geom.periodicity());
+
+    myPC.InterpolateSingleLevelSoA(acceleration, 0, 1, ParticleMesh::CIC);
+
+    err = 0.0;
+    for (MyParIter pti(myPC, 0); pti.isValid(); ++pti) {
+      const FArrayBox& fab = acceleration[pti];
+      for (const auto& p : pti.GetArrayOfStructs()) {
+        Real l[BL_SPACEDIM], w_hi[BL_SPACEDIM];
+        int i[BL_SPACEDIM];
+        for (int d = 0; d < BL_SPACEDIM; ++d) {
+          l[d] = (p.pos(d) - geom.ProbLo(d)) / dx[d] + 0.5;
+          i[d] = static_cast<int>(std::floor(l[d]));
+          w_hi[d] = l[d] - i[d];
+        }
+        for (int n = 0; n < BL_SPACEDIM; ++n) {
+          Real v = 0.0;
+          for (int c = 0; c < (1 << BL_SPACEDIM); ++c) {
+            IntVect iv;
+            Real w = 1.0;
+            for (int d = 0; d < BL_SPACEDIM; ++d) {
+              const int hi = (c >> d) & 1;
+              iv[d] = i[d] - 1 + hi;
+              w *= hi ? w_hi[d] : 1.0 - w_hi[d];
+            }
+            v += w * fab(iv,n);
+          }
+          err = std::max(err, std::abs(p.rdata(1+n) - v));
+        }
+      }
+    }
+    ParallelDescriptor::ReduceRealMax(err);
+    passed = passed && err < tol;
+
+    amrex::Print() << "CIC interpolation of a varying field, SoA vs Fortran weights, max error: "
+                   << err << "\n";
+
+    if (!passed) {
+      amrex::Abort("DepositionBenchmark: the SoA and Fortran kernels disagree");
+    }
+  }
+  amrex::Finalize();
+}
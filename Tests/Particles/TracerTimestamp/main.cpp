@@ -0,0 +1,137 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Utility.H>
+#include "AMReX_TracerParticles.H"
+
+using namespace amrex;
+
+//
+// Writes the same tracer history with the ASCII and the buffered binary
+// TracerParticleContainer::Timestamp, reads the binary file back with
+// ReadTimestampFile and checks it against the ASCII file.
+//
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+  {
+    ParmParse pp;
+
+    int nx, ny, nz, max_grid_size;
+    long nparticles;
+    int nsteps = 20;
+    pp.get("nx", nx);
+    pp.get("ny", ny);
+    pp.get("nz", nz);
+    pp.get("max_grid_size", max_grid_size);
+    pp.get("nparticles", nparticles);
+    pp.query("nsteps", nsteps);
+
+    RealBox real_box;
+    for (int n = 0; n < BL_SPACEDIM; n++) {
+      real_box.setLo(n, 0.0);
+      real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(nx-1,ny-1,nz-1)));
+    int is_per[BL_SPACEDIM];
+    for (int i = 0; i < BL_SPACEDIM; i++) is_per[i] = 1;
+    Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dmap(ba);
+
+    TracerParticleContainer tracers(geom, dmap, ba);
+
+    TracerParticleContainer::ParticleInitData pdata = {{AMREX_D_DECL(0.5, -1.0, 2.0)}};
+    tracers.InitRandom(nparticles, 451, pdata, true);
+
+    MultiFab mf(ba, dmap, 2, 1);
+    mf.setVal(1.5, 0, 1, 1);
+    mf.setVal(3.0, 1, 1, 1);
+    std::vector<int> indices = {0, 1};
+
+    const std::string ascii_name  = "ascii";
+    const std::string binary_name = "binary";
+    if (ParallelDescriptor::IOProcessor()) {
+      for (int i = 0; i < ParallelDescriptor::NProcs(); ++i) {
+        std::string a = amrex::Concatenate(ascii_name + '_', i, 2);
+        std::string b = amrex::Concatenate(binary_name + '_', i, 2) + ".bin";
+        std::remove(a.c_str());
+        std::remove(b.c_str());
+        std::remove((b + ".idx").c_str());
+      }
+    }
+    ParallelDescriptor::Barrier();
+
+    ParmParse ppp("particles");
+    ppp.add("timestamp_binary", 0);
+
+    Real strt = ParallelDescriptor::second();
+    for (int step = 0; step < nsteps; ++step) {
+      tracers.Timestamp(ascii_name, mf, 0, 0.1*step, indices);
+    }
+    Real ascii_time = ParallelDescriptor::second() - strt;
+
+    ppp.add("timestamp_binary", 1);
+
+    strt = ParallelDescriptor::second();
+    for (int step = 0; step < nsteps; ++step) {
+      tracers.Timestamp(binary_name, mf, 0, 0.1*step, indices);
+    }
+    tracers.FlushTimestamps();
+    Real binary_time = ParallelDescriptor::second() - strt;
+
+    ParallelDescriptor::ReduceRealMax(ascii_time);
+    ParallelDescriptor::ReduceRealMax(binary_time);
+
+    //
+    // Compare the two files written by this process.
+    //
+    const int nOutFiles = std::min(64, ParallelDescriptor::NProcs());
+    const int MyProc    = ParallelDescriptor::MyProc();
+    long nbad = 0;
+    long nread = 0;
+    if (MyProc < nOutFiles)
+    {
+      Vector<TracerParticleContainer::TimestampRecord> records;
+      TracerParticleContainer::ReadTimestampFile(amrex::Concatenate(binary_name + '_', MyProc, 2) + ".bin", records);
+
+      std::ifstream ascii(amrex::Concatenate(ascii_name + '_', MyProc, 2));
+      for (const auto& rec : records) {
+        for (int k = 0; k < rec.id.size(); ++k) {
+          int id, cpu;
+          Real pos[BL_SPACEDIM], vel[BL_SPACEDIM], vals[2], time;
+          ascii >> id >> cpu;
+          for (int d = 0; d < BL_SPACEDIM; ++d) ascii >> pos[d];
+          ascii >> time;
+          for (int d = 0; d < BL_SPACEDIM; ++d) ascii >> vel[d];
+          ascii >> vals[0] >> vals[1];
+          bool ok = (id == rec.id[k] && cpu == rec.cpu[k] && std::abs(time - rec.time) < 1.e-9);
+          for (int d = 0; d < BL_SPACEDIM; ++d) {
+            ok = ok && std::abs(pos[d] - rec.pos[d][k]) < 1.e-9 && std::abs(vel[d] - rec.vel[d][k]) < 1.e-9;
+          }
+          ok = ok && std::abs(vals[0] - rec.vals[0][k]) < 1.e-9 && std::abs(vals[1] - rec.vals[1][k]) < 1.e-9;
+          if (!ok) ++nbad;
+          ++nread;
+        }
+      }
+    }
+    ParallelDescriptor::ReduceLongSum(nbad);
+    ParallelDescriptor::ReduceLongSum(nread);
+
+    amrex::Print() << "ASCII  Timestamp time: " << ascii_time  << "\n"
+                   << "Binary Timestamp time: " << binary_time << "\n"
+                   << "Records compared: " << nread << " (expected " << nparticles*nsteps << ")"
+                   << ", mismatches: " << nbad << "\n";
+
+    if (nbad != 0 || nread != nparticles*nsteps) {
+      amrex::Abort("Binary Timestamp output does not match the ASCII output");
+    }
+  }
+  amrex::Finalize();
+}
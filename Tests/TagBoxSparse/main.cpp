@@ -0,0 +1,141 @@
+//
+// Runs the tag processing of AmrMesh::MakeNewGrids (buffer, clear,
+// coarsen, mapPeriodic, collate) on dense and on sparse TagBoxArrays,
+// and checks that both give the same tagged cells.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_TagBox.H>
+
+using namespace amrex;
+
+namespace {
+
+void
+init_tags (TagBoxArray& tags, const Box& domain, bool scattered)
+{
+    std::mt19937 gen(17+ParallelDescriptor::MyProc());
+    std::uniform_real_distribution<double> dist(0.0,1.0);
+
+    const Real rc = 0.5*domain.length(0);
+    const Real r0 = 0.3*domain.length(0);
+
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        TagBox& tb = tags[mfi];
+        for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+        {
+            if (scattered)
+            {
+                const double x = dist(gen);
+                if (x < 0.02) {
+                    tb(iv) = TagBox::SET;
+                } else if (x < 0.025) {
+                    tb(iv) = TagBox::BUF;
+                }
+            }
+            else
+            {
+                Real r2 = 0.0;
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    r2 += (iv[d]-rc)*(iv[d]-rc);
+                }
+                if (std::abs(std::sqrt(r2)-r0) < 1.5) tb(iv) = TagBox::SET;
+            }
+        }
+    }
+}
+
+Vector<IntVect>
+process_tags (const BoxArray& ba, const DistributionMapping& dm, const Geometry& geom,
+              int nbuf, int ratio, bool scattered, bool sparse, Real& time)
+{
+    TagBoxArray tags(ba, dm, nbuf);
+    init_tags(tags, geom.Domain(), scattered);
+
+    ParallelDescriptor::Barrier();
+    const Real strt = ParallelDescriptor::second();
+
+    if (sparse) tags.makeSparse();
+
+    tags.buffer(nbuf);
+
+    const Box& dom = geom.Domain();
+    BoxArray clear_ba(Box(dom.smallEnd(), dom.smallEnd()+IntVect(dom.length(0)/8)));
+    tags.setVal(clear_ba, TagBox::CLEAR);
+
+    tags.coarsen(IntVect(ratio));
+
+    const Box& cdomain = amrex::coarsen(dom, ratio);
+    tags.mapPeriodic(Geometry(cdomain));
+
+    BoxArray clear_edge(amrex::bdryLo(cdomain, 0, 1));
+    clear_edge.enclosedCells();
+    tags.setVal(clear_edge, TagBox::CLEAR);
+
+    Vector<IntVect> tv;
+    tags.collate(tv);
+
+    time = ParallelDescriptor::second() - strt;
+    ParallelDescriptor::ReduceRealMax(time);
+
+    std::sort(tv.begin(), tv.end(),
+              [] (const IntVect& a, const IntVect& b) -> bool {
+                  for (int d = AMREX_SPACEDIM-1; d >= 0; --d) {
+                      if (a[d] != b[d]) return a[d] < b[d];
+                  }
+                  return false;
+              });
+    return tv;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 128, max_grid_size = 32, n_error_buf = 4, ratio = 4, scattered = 0;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("n_error_buf", n_error_buf);
+            pp.query("ratio", ratio);
+            pp.query("scattered", scattered);
+        }
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        int is_periodic[] = {AMREX_D_DECL(1,1,0)};
+        Geometry geom(domain, &rb, 0, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        Real t_dense, t_sparse;
+        const Vector<IntVect> dense  = process_tags(ba, dm, geom, n_error_buf, ratio,
+                                                    scattered, false, t_dense);
+        const Vector<IntVect> sparse = process_tags(ba, dm, geom, n_error_buf, ratio,
+                                                    scattered, true, t_sparse);
+
+        amrex::Print() << "Number of tags: " << dense.size() << "\n"
+                       << "Dense  time: " << t_dense  << "\n"
+                       << "Sparse time: " << t_sparse << "\n";
+
+        if (dense != sparse) {
+            amrex::Abort("Dense and sparse tags differ");
+        }
+    }
+    amrex::Finalize();
+}